@@ -0,0 +1,269 @@
+// findings_3.cpp's Base/Derived, dispatched six ways over --objects=N
+// (default 10^6) objects of four Derived types in random order. Each
+// do_a_thing() is one multiply-add on the object's own state, so the
+// cost of getting to it is most of what is measured.
+//
+// virtual_unique_ptr    std::vector<std::unique_ptr<Base>>, a virtual
+//                       call per object, the types mixed: the indirect
+//                       branch is mispredicted about 3 times in 4
+// virtual_sorted        the same pointers sorted by type: still a
+//                       virtual call each, but the branch is predictable
+// final_batches         one std::vector per Derived type, Derived
+//                       final: calls through the concrete type are
+//                       devirtualized and inlined, each object still
+//                       carries its vtable pointer
+// crtp_batches          one std::vector per type, static polymorphism
+//                       (CRTP) instead of virtual: no vtable pointer
+// variant_visit         std::vector<std::variant<...>> in the mixed
+//                       order, std::visit per object (a jump table)
+// variant_sorted        the same, sorted by type
+//
+// The batch versions do the objects type by type instead of in the
+// original order; fine for independent updates like this one, not for
+// everything. ns/item is per object.
+
+#include "bench.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <memory>
+#include <random>
+#include <tuple>
+#include <utility>
+#include <variant>
+#include <vector>
+
+// The four types only differ in the constants of their update.
+constexpr std::uint64_t multipliers[] = {3, 5, 7, 11};
+constexpr std::uint64_t increments[] = {1, 2, 3, 4};
+
+namespace virtual_dispatch {
+
+struct Base
+{
+    virtual ~Base() = default;
+    Base() = default;
+    Base(const Base&) = default;
+    Base& operator=(const Base&) = default;
+    Base(Base&&) = default;
+    Base& operator=(Base&&) = default;
+    virtual void do_a_thing() = 0;
+    virtual std::uint64_t state() const = 0;
+};
+
+template <int K>
+struct Derived : Base
+{
+    explicit Derived(std::uint64_t seed) : m_state(seed) {}
+    void do_a_thing() override { m_state = m_state * multipliers[K] + increments[K]; }
+    std::uint64_t state() const override { return m_state; }
+    std::uint64_t m_state;
+};
+
+} // namespace virtual_dispatch
+
+namespace final_dispatch {
+
+using virtual_dispatch::Base;
+
+template <int K>
+struct Derived final : Base
+{
+    explicit Derived(std::uint64_t seed) : m_state(seed) {}
+    void do_a_thing() override { m_state = m_state * multipliers[K] + increments[K]; }
+    std::uint64_t state() const override { return m_state; }
+    std::uint64_t m_state;
+};
+
+} // namespace final_dispatch
+
+namespace crtp {
+
+template <typename D>
+struct Base
+{
+    void do_a_thing() { static_cast<D&>(*this).do_a_thing_impl(); }
+    std::uint64_t state() const { return static_cast<const D&>(*this).m_state; }
+};
+
+template <int K>
+struct Derived : Base<Derived<K>>
+{
+    explicit Derived(std::uint64_t seed) : m_state(seed) {}
+    void do_a_thing_impl() { m_state = m_state * multipliers[K] + increments[K]; }
+    std::uint64_t m_state;
+};
+
+} // namespace crtp
+
+// The variant's alternatives need no common base at all.
+namespace plain {
+
+template <int K>
+struct Derived
+{
+    explicit Derived(std::uint64_t seed) : m_state(seed) {}
+    void do_a_thing() { m_state = m_state * multipliers[K] + increments[K]; }
+    std::uint64_t state() const { return m_state; }
+    std::uint64_t m_state;
+};
+
+using any = std::variant<Derived<0>, Derived<1>, Derived<2>, Derived<3>>;
+
+} // namespace plain
+
+// One std::vector per type, for the batch versions.
+template <template <int> class D>
+using batches = std::tuple<std::vector<D<0>>, std::vector<D<1>>, std::vector<D<2>>, std::vector<D<3>>>;
+
+template <template <int> class D>
+batches<D> make_batches(const std::vector<int>& kinds)
+{
+    batches<D> b;
+    for (std::size_t i = 0; i < kinds.size(); ++i)
+        switch (kinds[i])
+        {
+        case 0: std::get<0>(b).emplace_back(i); break;
+        case 1: std::get<1>(b).emplace_back(i); break;
+        case 2: std::get<2>(b).emplace_back(i); break;
+        default: std::get<3>(b).emplace_back(i); break;
+        }
+    return b;
+}
+
+template <typename Batches>
+BENCH_NOINLINE void run_batches(Batches& b)
+{
+    std::apply(
+        [](auto&... vectors) {
+            (std::for_each(vectors.begin(), vectors.end(), [](auto& d) { d.do_a_thing(); }), ...);
+        },
+        b);
+}
+
+template <typename Batches>
+std::uint64_t checksum_batches(const Batches& b)
+{
+    std::uint64_t sum = 0;
+    std::apply(
+        [&](const auto&... vectors) {
+            (std::for_each(vectors.begin(), vectors.end(), [&](const auto& d) { sum += d.state(); }), ...);
+        },
+        b);
+    return sum;
+}
+
+BENCH_NOINLINE void run_pointers(const std::vector<std::unique_ptr<virtual_dispatch::Base>>& objects)
+{
+    for (const auto& object : objects)
+        object->do_a_thing();
+}
+
+std::uint64_t checksum_pointers(const std::vector<std::unique_ptr<virtual_dispatch::Base>>& objects)
+{
+    std::uint64_t sum = 0;
+    for (const auto& object : objects)
+        sum += object->state();
+    return sum;
+}
+
+BENCH_NOINLINE void run_variants(std::vector<plain::any>& objects)
+{
+    for (auto& object : objects)
+        std::visit([](auto& d) { d.do_a_thing(); }, object);
+}
+
+std::uint64_t checksum_variants(const std::vector<plain::any>& objects)
+{
+    std::uint64_t sum = 0;
+    for (const auto& object : objects)
+        sum += std::visit([](const auto& d) { return d.state(); }, object);
+    return sum;
+}
+
+int main(int argc, char** argv)
+{
+    bench::runner r("dispatch", argc, argv);
+
+    const auto n = static_cast<std::size_t>(r.param("objects", r.size(1000000L, 10000L)));
+    std::mt19937 rng(42);
+    std::vector<int> kinds(n);
+    for (int& kind : kinds)
+        kind = static_cast<int>(rng() % 4);
+
+    std::vector<std::unique_ptr<virtual_dispatch::Base>> mixed;
+    std::vector<plain::any> variants;
+    mixed.reserve(n);
+    variants.reserve(n);
+    for (std::size_t i = 0; i < n; ++i)
+        switch (kinds[i])
+        {
+        case 0:
+            mixed.push_back(std::make_unique<virtual_dispatch::Derived<0>>(i));
+            variants.emplace_back(plain::Derived<0>(i));
+            break;
+        case 1:
+            mixed.push_back(std::make_unique<virtual_dispatch::Derived<1>>(i));
+            variants.emplace_back(plain::Derived<1>(i));
+            break;
+        case 2:
+            mixed.push_back(std::make_unique<virtual_dispatch::Derived<2>>(i));
+            variants.emplace_back(plain::Derived<2>(i));
+            break;
+        default:
+            mixed.push_back(std::make_unique<virtual_dispatch::Derived<3>>(i));
+            variants.emplace_back(plain::Derived<3>(i));
+            break;
+        }
+
+    // Sorted by type: the same objects, where the pointers are concerned.
+    std::vector<std::unique_ptr<virtual_dispatch::Base>> sorted;
+    {
+        std::vector<std::size_t> order(n);
+        for (std::size_t i = 0; i < n; ++i)
+            order[i] = i;
+        std::stable_sort(order.begin(), order.end(), [&](std::size_t a, std::size_t b) { return kinds[a] < kinds[b]; });
+        // fresh objects, so that both pointer versions start from the same states
+        sorted.reserve(n);
+        for (std::size_t i : order)
+            switch (kinds[i])
+            {
+            case 0: sorted.push_back(std::make_unique<virtual_dispatch::Derived<0>>(i)); break;
+            case 1: sorted.push_back(std::make_unique<virtual_dispatch::Derived<1>>(i)); break;
+            case 2: sorted.push_back(std::make_unique<virtual_dispatch::Derived<2>>(i)); break;
+            default: sorted.push_back(std::make_unique<virtual_dispatch::Derived<3>>(i)); break;
+            }
+    }
+    std::vector<plain::any> sorted_variants = variants;
+    std::stable_sort(sorted_variants.begin(), sorted_variants.end(),
+                     [](const plain::any& a, const plain::any& b) { return a.index() < b.index(); });
+
+    auto final_objects = make_batches<final_dispatch::Derived>(kinds);
+    auto crtp_objects = make_batches<crtp::Derived>(kinds);
+
+    // Every version applies the same updates to the same objects.
+    run_pointers(mixed);
+    run_pointers(sorted);
+    run_batches(final_objects);
+    run_batches(crtp_objects);
+    run_variants(variants);
+    run_variants(sorted_variants);
+    const std::uint64_t expected = checksum_pointers(mixed);
+    if (checksum_pointers(sorted) != expected || checksum_batches(final_objects) != expected ||
+        checksum_batches(crtp_objects) != expected || checksum_variants(variants) != expected ||
+        checksum_variants(sorted_variants) != expected)
+    {
+        std::fprintf(stderr, "the dispatch versions disagree\n");
+        return 1;
+    }
+
+    r.run("do_a_thing", "virtual_unique_ptr", n, [&] { run_pointers(mixed); });
+    r.run("do_a_thing", "virtual_sorted", n, [&] { run_pointers(sorted); });
+    r.run("do_a_thing", "final_batches", n, [&] { run_batches(final_objects); });
+    r.run("do_a_thing", "crtp_batches", n, [&] { run_batches(crtp_objects); });
+    r.run("do_a_thing", "variant_visit", n, [&] { run_variants(variants); });
+    r.run("do_a_thing", "variant_sorted", n, [&] { run_variants(sorted_variants); });
+
+    return r.finish();
+}
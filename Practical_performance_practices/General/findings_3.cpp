@@ -29,6 +29,8 @@ struct Derived: Base
 
 // so the following is better
 // 10% improvement 
+// (dispatch_bench.cpp: what the virtual call itself costs, against
+// final, CRTP, std::variant and batches sorted by type)
 
 struct Base
 {
@@ -0,0 +1,197 @@
+// Benchmarks for the claims in findings_1.cpp, findings_2.cpp and
+// findings_3.cpp (https://www.youtube.com/watch?v=uzF4u9KgUWI).
+//
+// findings_1: construct and initialize in one step instead of
+//             default construct + assign ("32% more efficient"),
+//             and initialize a const through a lambda instead of
+//             assigning inside a switch ("31% more efficient").
+// findings_2: initialize members in the initializer list (and move
+//             the by-value parameter) instead of assigning in the body.
+// findings_3: a user declared destructor in Derived silently removes
+//             its move operations, so a std::vector<Derived> copies on
+//             every reallocation ("10% improvement" once fixed).
+
+#include "bench.h"
+
+#include <cstdlib>
+#include <string>
+#include <utility>
+#include <vector>
+
+// findings_1 ------------------------------------------------------------
+
+BENCH_NOINLINE std::string assign_after_construct()
+{
+    std::string s;
+    s = "A string";
+    return s;
+}
+
+BENCH_NOINLINE std::string construct_and_initialize()
+{
+    const std::string s1 = "A string";
+    return s1;
+}
+
+// Longer than the small string buffer, so the difference in the
+// number of allocations also shows up.
+BENCH_NOINLINE std::string switch_assign(int i)
+{
+    std::string S2;
+    switch (i % 4)
+    {
+    case 0:
+        S2 = "string0 that does not fit the small buffer";
+        break;
+    case 1:
+        S2 = "string1 that does not fit the small buffer";
+        break;
+    case 2:
+        S2 = "string2 that does not fit the small buffer";
+        break;
+    case 3:
+        S2 = "string3 that does not fit the small buffer";
+        break;
+    }
+    return S2;
+}
+
+BENCH_NOINLINE std::string lambda_initialize(int i)
+{
+    const std::string S2 = [&]() {
+        switch (i % 4)
+        {
+        case 0:
+            return "string0 that does not fit the small buffer";
+        case 1:
+            return "string1 that does not fit the small buffer";
+        case 2:
+            return "string2 that does not fit the small buffer";
+        default:
+            return "string3 that does not fit the small buffer";
+        }
+    }();
+    return S2;
+}
+
+// findings_2 ------------------------------------------------------------
+
+struct test
+{
+    test(std::string t_s)
+    {
+        m_s = t_s;
+    }
+    int val() const { return std::atoi(m_s.c_str()); }
+
+    std::string m_s;
+};
+
+struct test1
+{
+    test1(std::string t_s) : m_s(std::move(t_s)) {}
+    int val() const { return std::atoi(m_s.c_str()); }
+
+    std::string m_s;
+};
+
+// findings_3 ------------------------------------------------------------
+// Derived carries a string so that copying it actually costs something.
+
+namespace before {
+
+struct Base
+{
+    virtual ~Base() = default;
+    virtual void do_a_thing() = 0;
+};
+
+struct Derived : Base
+{
+    explicit Derived(std::string name) : m_name(std::move(name)) {}
+    virtual ~Derived() = default;   // disables the implicit move operations
+    void do_a_thing() override {}
+    std::string m_name;
+};
+
+} // namespace before
+
+namespace after {
+
+struct Base
+{
+    virtual ~Base() = default;
+    Base() = default;
+    Base(const Base&) = default;
+    Base& operator=(const Base&) = default;
+    Base(Base&&) = default;
+    Base& operator=(Base&&) = default;
+    virtual void do_a_thing() = 0;
+};
+
+struct Derived : Base
+{
+    explicit Derived(std::string name) : m_name(std::move(name)) {}
+    void do_a_thing() override {}
+    std::string m_name;
+};
+
+} // namespace after
+
+template <typename Derived>
+std::size_t grow_vector(std::size_t count)
+{
+    std::vector<Derived> v;   // no reserve: we want the reallocations
+    for (std::size_t k = 0; k < count; ++k)
+        v.emplace_back("a name long enough to need the heap");
+    return v.size();
+}
+
+int main(int argc, char** argv)
+{
+    bench::runner r("findings", argc, argv);
+
+    const int loops = r.size(1000000, 10000);
+
+    r.run("findings_1_construct", "assign_after_construct", loops, [&] {
+        for (int i = 0; i < loops; ++i)
+            bench::do_not_optimize(assign_after_construct());
+    });
+    r.run("findings_1_construct", "construct_and_initialize", loops, [&] {
+        for (int i = 0; i < loops; ++i)
+            bench::do_not_optimize(construct_and_initialize());
+    });
+
+    r.run("findings_1_const_init", "switch_assign", loops, [&] {
+        for (int i = 0; i < loops; ++i)
+            bench::do_not_optimize(switch_assign(i));
+    });
+    r.run("findings_1_const_init", "lambda_initialize", loops, [&] {
+        for (int i = 0; i < loops; ++i)
+            bench::do_not_optimize(lambda_initialize(i));
+    });
+
+    const std::string long_string = "12345 and enough characters to leave the small buffer";
+    r.run("findings_2_member_init", "assign_in_body", loops, [&] {
+        for (int i = 0; i < loops; ++i)
+        {
+            test t(long_string);
+            bench::do_not_optimize(t);
+        }
+    });
+    r.run("findings_2_member_init", "initializer_list_move", loops, [&] {
+        for (int i = 0; i < loops; ++i)
+        {
+            test1 t(long_string);
+            bench::do_not_optimize(t);
+        }
+    });
+
+    const std::size_t count = r.size<std::size_t>(100000, 1000);
+    r.run("findings_3_vector_growth", "Derived_copied", count,
+          [&] { bench::do_not_optimize(grow_vector<before::Derived>(count)); });
+    r.run("findings_3_vector_growth", "Derived_moved", count,
+          [&] { bench::do_not_optimize(grow_vector<after::Derived>(count)); });
+
+    return r.finish();
+}
@@ -0,0 +1,52 @@
+// Benchmark for the three slides in this folder:
+//
+// copying_bad.png      S o(s);                  -> s is copied into t_s
+// solution.png         S o(std::move(s));       -> "29% more efficient"
+// better_solution.png  S o(std::string(..) + "b"); no named temporary
+//                                               -> "2% more efficient again"
+
+#include "bench.h"
+
+#include <string>
+#include <utility>
+
+struct S
+{
+    S(std::string t_s) : s(std::move(t_s)) {}
+    std::string s;
+};
+
+int main(int argc, char** argv)
+{
+    bench::runner r("copying_move", argc, argv);
+
+    const int loops = r.size(1000000, 10000);
+
+    r.run("string_into_S", "copy", loops, [&] {
+        for (int i = 0; i < loops; ++i)
+        {
+            std::string s = std::string("a not very short string") + "b";
+            S o(s);
+            bench::do_not_optimize(o);
+        }
+    });
+
+    r.run("string_into_S", "std::move", loops, [&] {
+        for (int i = 0; i < loops; ++i)
+        {
+            std::string s = std::string("a not very short string") + "b";
+            S o(std::move(s));
+            bench::do_not_optimize(o);
+        }
+    });
+
+    r.run("string_into_S", "no_named_temporary", loops, [&] {
+        for (int i = 0; i < loops; ++i)
+        {
+            S o(std::string("a not very short string") + "b");
+            bench::do_not_optimize(o);
+        }
+    });
+
+    return r.finish();
+}
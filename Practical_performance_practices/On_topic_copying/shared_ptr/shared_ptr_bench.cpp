@@ -0,0 +1,86 @@
+// Benchmark for the slides in this folder:
+//
+// shared_ptr.png       use_a_base(std::shared_ptr<Base> p)
+//                      -> a copy (refcount ++/--) on every call
+// shared_ptr_sol1.png  use_a_base(const std::shared_ptr<Base>& p)
+//                      -> "Fixed! Right? Wrong!" the argument is a
+//                         shared_ptr<Derived>, so a temporary
+//                         shared_ptr<Base> is still created per call
+// final_sol.png        use_a_base(const Base& p)
+//                      -> "2.5x faster than the last"
+//
+// The slide passes ptr.get() to a const Base& (one of the bugs the
+// readme mentions); here it is *ptr and p.value() as intended.
+
+#include "bench.h"
+
+#include <memory>
+
+struct Base
+{
+    virtual ~Base() = default;
+    virtual int value() const = 0;
+};
+
+struct Derived : Base
+{
+    int value() const override { return 42; }
+};
+
+// noinline: otherwise the compiler sees through the call and may
+// drop the very reference count traffic we want to measure.
+BENCH_NOINLINE int use_a_base_by_value(std::shared_ptr<Base> p)
+{
+    return p->value();
+}
+
+BENCH_NOINLINE int use_a_base_by_cref(const std::shared_ptr<Base>& p)
+{
+    return p->value();
+}
+
+BENCH_NOINLINE int use_a_base(const Base& p)
+{
+    return p.value();
+}
+
+int main(int argc, char** argv)
+{
+    bench::runner r("copying_shared_ptr", argc, argv);
+
+    const int loops = r.size(10000000, 10000);
+    auto ptr = std::make_shared<Derived>();
+    std::shared_ptr<Base> base_ptr = ptr;
+
+    r.run("use_a_base", "shared_ptr<Base>_by_value", loops, [&] {
+        int sum = 0;
+        for (int i = 0; i < loops; ++i)
+            sum += use_a_base_by_value(ptr);
+        bench::do_not_optimize(sum);
+    });
+
+    r.run("use_a_base", "const_shared_ptr<Base>&_from_Derived", loops, [&] {
+        int sum = 0;
+        for (int i = 0; i < loops; ++i)
+            sum += use_a_base_by_cref(ptr);
+        bench::do_not_optimize(sum);
+    });
+
+    // No conversion needed: what sol1 would cost if the caller
+    // already held a shared_ptr<Base>.
+    r.run("use_a_base", "const_shared_ptr<Base>&_from_Base", loops, [&] {
+        int sum = 0;
+        for (int i = 0; i < loops; ++i)
+            sum += use_a_base_by_cref(base_ptr);
+        bench::do_not_optimize(sum);
+    });
+
+    r.run("use_a_base", "const_Base&", loops, [&] {
+        int sum = 0;
+        for (int i = 0; i < loops; ++i)
+            sum += use_a_base(*ptr);
+        bench::do_not_optimize(sum);
+    });
+
+    return r.finish();
+}
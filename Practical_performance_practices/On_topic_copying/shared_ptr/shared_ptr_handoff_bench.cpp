@@ -0,0 +1,141 @@
+// The slides of this folder once more, with several threads handing the
+// same shared_ptr<Derived> to use_a_base at the same time.
+//
+// Single threaded, a reference count increment is a locked instruction
+// on a line the core already owns. With several threads sharing one
+// object, every increment and decrement also has to pull the control
+// block's cache line away from the core that touched it last, so the
+// hidden copies of readme.mdt (pass by value, and the temporary
+// shared_ptr<Base> that const shared_ptr<Base>& still creates from a
+// shared_ptr<Derived>) get far more expensive per call, and more so the
+// more threads join in.
+//
+// Per thread count 1, 2, 4, ... (up to the CPUs, --threads=N to pick
+// the largest) every worker of a pinned pool makes --loops calls of:
+//
+//   by_value                 use_a_base(shared_ptr<Base>) with the shared object
+//   cref_from_Derived        use_a_base(const shared_ptr<Base>&), same object
+//   by_value_private         by value, but every thread has its own object,
+//                            control block on cache lines of its own: the
+//                            atomics without the sharing
+//   cref_from_Base           each thread holds its own shared_ptr<Base>: no count
+//   raw_pointer              use_a_base(const Base*): borrowed, no count
+//   const_Base&              use_a_base(const Base&): borrowed, no count
+//
+// ns/item is wall time per call and thread (all threads run at once).
+// The difference between by_value and by_value_private is printed as
+// the cache line ping-pong cost per hand-off.
+
+#include "bench.h"
+#include "pinned_pool.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <memory>
+#include <string>
+#include <vector>
+
+struct Base
+{
+    virtual ~Base() = default;
+    virtual int value() const = 0;
+};
+
+struct Derived : Base
+{
+    int value() const override { return 42; }
+};
+
+// make_shared puts the counts next to the object, and blocks allocated
+// one after the other end up next to each other: without the alignment
+// two threads' "private" counts would share a line, which is the very
+// ping-pong by_value_private is there to leave out. Over-aligned, the
+// whole block (counts, then the object) starts on a line of its own.
+struct alignas(64) DerivedOwnLine : Derived
+{
+};
+
+BENCH_NOINLINE int use_a_base_by_value(std::shared_ptr<Base> p)
+{
+    return p->value();
+}
+
+BENCH_NOINLINE int use_a_base_by_cref(const std::shared_ptr<Base>& p)
+{
+    return p->value();
+}
+
+BENCH_NOINLINE int use_a_base_by_pointer(const Base* p)
+{
+    return p->value();
+}
+
+BENCH_NOINLINE int use_a_base(const Base& p)
+{
+    return p.value();
+}
+
+double median_per_item(const bench::runner& r, const std::string& group, const std::string& name)
+{
+    for (const auto& result : r.results())
+        if (result.group == group && result.name == name)
+            return result.ns.median / result.items;
+    return 0;
+}
+
+int main(int argc, char** argv)
+{
+    bench::runner r("shared_ptr_handoff", argc, argv);
+
+    const long loops = r.param("loops", r.size(1000000L, 10000L));
+    const bool pin = r.param("pin", 1) != 0;
+    const auto max_threads =
+        static_cast<unsigned>(std::max(1L, r.param("threads", static_cast<long>(bench::available_cpus().size()))));
+
+    std::vector<unsigned> counts;
+    for (unsigned t = 1; t < max_threads; t *= 2)
+        counts.push_back(t);
+    counts.push_back(max_threads);
+
+    const auto shared = std::make_shared<Derived>();
+
+    for (unsigned threads : counts)
+    {
+        bench::pinned_pool pool(threads, pin);
+        std::vector<std::shared_ptr<Derived>> private_objects;
+        std::vector<std::shared_ptr<Base>> base_copies;
+        for (unsigned t = 0; t < threads; ++t)
+        {
+            private_objects.push_back(std::make_shared<DerivedOwnLine>());
+            base_copies.push_back(shared);
+        }
+
+        const std::string group = "handoff_" + std::to_string(threads) + "t";
+        // every worker runs `call(worker)` `loops` times
+        auto run = [&](const char* name, auto call) {
+            r.run(group, name, static_cast<std::size_t>(loops), [&] {
+                pool.run([&](unsigned w) {
+                    int sum = 0;
+                    for (long i = 0; i < loops; ++i)
+                        sum += call(w);
+                    bench::do_not_optimize(sum);
+                });
+            });
+        };
+
+        run("by_value", [&](unsigned) { return use_a_base_by_value(shared); });
+        run("cref_from_Derived", [&](unsigned) { return use_a_base_by_cref(shared); });
+        run("by_value_private", [&](unsigned w) { return use_a_base_by_value(private_objects[w]); });
+        run("cref_from_Base", [&](unsigned w) { return use_a_base_by_cref(base_copies[w]); });
+        run("raw_pointer", [&](unsigned) { return use_a_base_by_pointer(shared.get()); });
+        run("const_Base&", [&](unsigned) { return use_a_base(*shared); });
+
+        const double shared_ns = median_per_item(r, group, "by_value");
+        const double private_ns = median_per_item(r, group, "by_value_private");
+        if (threads > 1 && shared_ns > 0 && private_ns > 0)
+            std::printf("  %s: cache line ping-pong %.1f ns per hand-off\n", group.c_str(),
+                        shared_ns - private_ns);
+    }
+
+    return r.finish();
+}
@@ -0,0 +1,80 @@
+// Benchmark for the struct layouts drawn in this folder:
+//
+// struct_memory.png
+//   char c; double d; short s; int i;  -> 24 bytes (padding after c and s)
+//   char c; short s; int i; double d;  -> 16 bytes (same members, reordered)
+// struct_memory_unaligned.png
+//   the same reordered struct __attribute__((packed)) -> 15 bytes,
+//   smaller still, but now the double straddles its natural alignment.
+//
+// The smaller the record, the more records per cache line and the
+// less memory bandwidth a loop over a big vector of them needs.
+
+#include "bench.h"
+#include "foo.h"
+
+#include <cstdint>
+#include <numeric>
+#include <random>
+#include <vector>
+
+template <typename Foo>
+std::vector<Foo> make_foos(std::size_t count)
+{
+    std::vector<Foo> foos(count);
+    for (std::size_t k = 0; k < count; ++k)
+    {
+        foos[k].c = static_cast<char>(k);
+        foos[k].s = static_cast<short>(k);
+        foos[k].i = static_cast<int>(k);
+        foos[k].d = static_cast<double>(k) * 0.5;
+    }
+    return foos;
+}
+
+// Touches every member so the whole record has to be brought in.
+template <typename Foo>
+double sum_all(const std::vector<Foo>& foos)
+{
+    double sum = 0;
+    for (const auto& foo : foos)
+        sum += foo.c + foo.s + foo.i + foo.d;
+    return sum;
+}
+
+template <typename Foo>
+double sum_all(const std::vector<Foo>& foos, const std::vector<std::uint32_t>& order)
+{
+    double sum = 0;
+    for (auto k : order)
+    {
+        const auto& foo = foos[k];
+        sum += foo.c + foo.s + foo.i + foo.d;
+    }
+    return sum;
+}
+
+template <typename Foo>
+void run_layout(bench::runner& r, const char* name, std::size_t count,
+                const std::vector<std::uint32_t>& order)
+{
+    const auto foos = make_foos<Foo>(count);
+    r.run("sequential", name, count, [&] { bench::do_not_optimize(sum_all(foos)); });
+    r.run("random", name, count, [&] { bench::do_not_optimize(sum_all(foos, order)); });
+}
+
+int main(int argc, char** argv)
+{
+    bench::runner r("aligned_unaligned", argc, argv);
+
+    const std::size_t count = r.size<std::size_t>(1 << 23, 1 << 12);
+    std::vector<std::uint32_t> order(count);
+    std::iota(order.begin(), order.end(), 0u);
+    std::shuffle(order.begin(), order.end(), std::mt19937(42));
+
+    run_layout<FooPadded>(r, "padded_24B", count, order);
+    run_layout<FooReordered>(r, "reordered_16B", count, order);
+    run_layout<FooPacked>(r, "packed_15B", count, order);
+
+    return r.finish();
+}
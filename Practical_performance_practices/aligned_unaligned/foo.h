@@ -0,0 +1,75 @@
+#pragma once
+
+// The three Foo layouts drawn in struct_memory.png and
+// struct_memory_unaligned.png, with their layout checked at compile time.
+
+#include "struct_layout.h"
+
+// char c; double d; short s; int i;  -> 24 bytes
+struct FooPadded
+{
+    char c;
+    double d;
+    short s;
+    int i;
+};
+
+// same members, reordered -> 16 bytes
+struct FooReordered
+{
+    char c;
+    short s;
+    int i;
+    double d;
+};
+
+// reordered and packed -> 15 bytes, the double is no longer aligned
+#if defined(__GNUC__) || defined(__clang__)
+struct __attribute__((packed)) FooPacked
+{
+    char c;
+    short s;
+    int i;
+    double d;
+};
+#else
+#pragma pack(push, 1)
+struct FooPacked
+{
+    char c;
+    short s;
+    int i;
+    double d;
+};
+#pragma pack(pop)
+#endif
+
+constexpr auto foo_padded_layout = layout::describe<FooPadded>(
+    "FooPadded", LAYOUT_MEMBER(FooPadded, c), LAYOUT_MEMBER(FooPadded, d),
+    LAYOUT_MEMBER(FooPadded, s), LAYOUT_MEMBER(FooPadded, i));
+
+constexpr auto foo_reordered_layout = layout::describe<FooReordered>(
+    "FooReordered", LAYOUT_MEMBER(FooReordered, c), LAYOUT_MEMBER(FooReordered, s),
+    LAYOUT_MEMBER(FooReordered, i), LAYOUT_MEMBER(FooReordered, d));
+
+constexpr auto foo_packed_layout = layout::describe<FooPacked>(
+    "FooPacked", LAYOUT_MEMBER(FooPacked, c), LAYOUT_MEMBER(FooPacked, s),
+    LAYOUT_MEMBER(FooPacked, i), LAYOUT_MEMBER(FooPacked, d));
+
+static_assert(sizeof(FooPadded) == 24 && alignof(FooPadded) == 8, "see struct_memory.png");
+static_assert(sizeof(FooReordered) == 16 && alignof(FooReordered) == 8, "see struct_memory.png");
+static_assert(sizeof(FooPacked) == 15 && alignof(FooPacked) == 1, "see struct_memory_unaligned.png");
+
+static_assert(layout::declared_size<char, double, short, int>() == sizeof(FooPadded));
+static_assert(layout::optimal_size<char, double, short, int>() == sizeof(FooReordered));
+
+static_assert(foo_padded_layout.covers_struct());
+static_assert(foo_reordered_layout.covers_struct());
+static_assert(foo_packed_layout.covers_struct());
+
+// FooPadded is the "before" on purpose; the other two must stay minimal.
+static_assert(!foo_padded_layout.is_padding_minimal());
+static_assert(foo_reordered_layout.is_padding_minimal(), "FooReordered gained padding");
+static_assert(foo_packed_layout.is_padding_minimal(), "FooPacked gained padding");
+static_assert(foo_packed_layout.members[3].align == 1 && foo_packed_layout.optimal_size() == 15,
+              "FooPacked's members are aligned to 1, whatever their type");
@@ -0,0 +1,103 @@
+// Padding report for the hot records of this repository.
+//
+// Prints, for every registered struct, where each member lives, where
+// the compiler had to insert padding, and the padding minimal member
+// order with the size it would give (see struct_layout.h).
+//
+// usage: padding_report [--only NAME [--fail-on-padding]]
+//   --only NAME         report only the struct called NAME
+//   --fail-on-padding   exit with 1 when the struct is not padding
+//                       minimal; needs --only, since FooPadded and Foo
+//                       are registered as the padded "before" on purpose
+//
+// To add a struct: describe it with layout::describe next to its
+// definition and add it to the list at the bottom of main().
+
+#include "foo.h"
+#include "../array_traversal/foo_bar.h"
+#include "struct_layout.h"
+
+#include <cstdio>
+#include <cstring>
+#include <string>
+
+constexpr auto foo_layout = layout::describe<Foo>(
+    "Foo", LAYOUT_MEMBER(Foo, c), LAYOUT_MEMBER(Foo, d), LAYOUT_MEMBER(Foo, s), LAYOUT_MEMBER(Foo, i));
+constexpr auto bar_layout = layout::describe<Bar>(
+    "Bar", LAYOUT_MEMBER(Bar, lo), LAYOUT_MEMBER(Bar, mid), LAYOUT_MEMBER(Bar, hi));
+constexpr auto foobar_layout = layout::describe<FooBar>(
+    "FooBar", LAYOUT_MEMBER(FooBar, foo), LAYOUT_MEMBER(FooBar, bar));
+
+static_assert(foo_layout.covers_struct() && bar_layout.covers_struct() && foobar_layout.covers_struct());
+
+struct report_options
+{
+    std::string only;
+    bool fail_on_padding = false;
+};
+
+// Returns true when the struct is padding minimal.
+template <std::size_t N>
+bool report(const layout::struct_info<N>& info, const report_options& opt)
+{
+    if (!opt.only.empty() && opt.only != info.name)
+        return true;
+
+    std::printf("%s: size %zu, align %zu, padding %zu byte(s) (%.1f%%)\n", info.name, info.size,
+                info.align, info.padding(), info.size ? 100.0 * info.padding() / info.size : 0.0);
+    std::printf("  %6s %6s %6s  %s\n", "offset", "size", "align", "member");
+
+    std::size_t end = 0;
+    for (const auto& m : info.members)
+    {
+        if (m.offset > end)
+            std::printf("  %6zu %6zu %6s  <padding>\n", end, m.offset - end, "");
+        std::printf("  %6zu %6zu %6zu  %s\n", m.offset, m.size, m.align, m.name);
+        end = m.offset + m.size;
+    }
+    if (info.size > end)
+        std::printf("  %6zu %6zu %6s  <tail padding>\n", end, info.size - end, "");
+
+    const auto order = info.best_order();
+    std::printf("  padding minimal order:");
+    for (auto k : order)
+        std::printf(" %s", info.members[k].name);
+    if (info.is_padding_minimal())
+        std::printf(" -> %zu bytes, already minimal\n\n", info.optimal_size());
+    else
+        std::printf(" -> %zu bytes, saves %zu byte(s) per record\n\n", info.optimal_size(),
+                    info.size - info.optimal_size());
+    return info.is_padding_minimal();
+}
+
+int main(int argc, char** argv)
+{
+    report_options opt;
+    for (int i = 1; i < argc; ++i)
+    {
+        if (!std::strcmp(argv[i], "--only") && i + 1 < argc)
+            opt.only = argv[++i];
+        else if (!std::strcmp(argv[i], "--fail-on-padding"))
+            opt.fail_on_padding = true;
+        else
+        {
+            std::fprintf(stderr, "usage: %s [--only NAME [--fail-on-padding]]\n", argv[0]);
+            return 2;
+        }
+    }
+    if (opt.fail_on_padding && opt.only.empty())
+    {
+        std::fprintf(stderr, "--fail-on-padding needs --only NAME: FooPadded and Foo are padded on purpose\n");
+        return 2;
+    }
+
+    bool minimal = true;
+    minimal &= report(foo_padded_layout, opt);
+    minimal &= report(foo_reordered_layout, opt);
+    minimal &= report(foo_packed_layout, opt);
+    minimal &= report(foo_layout, opt);
+    minimal &= report(bar_layout, opt);
+    minimal &= report(foobar_layout, opt);
+
+    return opt.fail_on_padding && !minimal ? 1 : 0;
+}
@@ -0,0 +1,202 @@
+#pragma once
+
+// Compile time struct layout checks, so padding in hot records is
+// caught by the build instead of by drawing boxes (struct_memory.png).
+//
+// Every member is placed at the next multiple of its alignment and the
+// struct is rounded up to a multiple of its largest alignment. Putting
+// the members in order of decreasing alignment therefore never leaves
+// a hole between them (for the usual power of two alignments), which
+// is the padding minimal order:
+//
+//   char c; double d; short s; int i;   -> 24 bytes, 9 of them padding
+//   double d; int i; short s; char c;   -> 16 bytes, 1 of them padding
+//
+// Two ways to use it:
+//
+// 1) On a list of types, no struct needed:
+//
+//      static_assert(layout::declared_size<char, double, short, int>() == 24);
+//      static_assert(layout::optimal_size<char, double, short, int>() == 16);
+//      layout::optimal_order<char, double, short, int>()  // {1, 3, 2, 0}
+//
+// 2) On a real struct, listing its members in declaration order (C++
+//    has no reflection, so the list is written by hand; LAYOUT_MEMBER
+//    fills in the size, alignment and the real offset):
+//
+//      constexpr auto foo_layout = layout::describe<Foo>(
+//          "Foo", LAYOUT_MEMBER(Foo, c), LAYOUT_MEMBER(Foo, d), ...);
+//      static_assert(foo_layout.covers_struct(), "a member is missing from the list");
+//      static_assert(foo_layout.is_padding_minimal(), "reorder Foo's members");
+//
+//    The same description feeds the padding report (padding_report.cpp).
+
+#include <array>
+#include <cstddef>
+
+namespace layout {
+
+struct member_info
+{
+    const char* name = "";
+    std::size_t size = 0;
+    std::size_t align = 1;
+    std::size_t offset = 0;
+};
+
+constexpr std::size_t align_up(std::size_t offset, std::size_t align)
+{
+    return (offset + align - 1) / align * align;
+}
+
+// Size of a struct with the given members in the given order.
+template <std::size_t N>
+constexpr std::size_t size_in_order(const std::array<member_info, N>& members,
+                                    const std::array<std::size_t, N>& order)
+{
+    std::size_t offset = 0;
+    std::size_t max_align = 1;
+    for (std::size_t k = 0; k < N; ++k)
+    {
+        const auto& m = members[order[k]];
+        offset = align_up(offset, m.align) + m.size;
+        max_align = m.align > max_align ? m.align : max_align;
+    }
+    return align_up(offset, max_align);
+}
+
+// Member indices sorted by decreasing alignment (then size), stable
+// so that equally aligned members keep their declared order.
+template <std::size_t N>
+constexpr std::array<std::size_t, N> optimal_order(const std::array<member_info, N>& members)
+{
+    std::array<std::size_t, N> order{};
+    for (std::size_t k = 0; k < N; ++k)
+        order[k] = k;
+    auto before = [&](std::size_t a, std::size_t b) {
+        if (members[a].align != members[b].align)
+            return members[a].align > members[b].align;
+        return members[a].size > members[b].size;
+    };
+    for (std::size_t k = 1; k < N; ++k)
+        for (std::size_t j = k; j > 0 && before(order[j], order[j - 1]); --j)
+        {
+            const auto tmp = order[j];
+            order[j] = order[j - 1];
+            order[j - 1] = tmp;
+        }
+    return order;
+}
+
+template <std::size_t N>
+constexpr std::array<std::size_t, N> declared_order()
+{
+    std::array<std::size_t, N> order{};
+    for (std::size_t k = 0; k < N; ++k)
+        order[k] = k;
+    return order;
+}
+
+// 1) type list interface -------------------------------------------------
+
+template <typename... Ts>
+constexpr std::array<member_info, sizeof...(Ts)> members_of()
+{
+    return {member_info{"", sizeof(Ts), alignof(Ts), 0}...};
+}
+
+template <typename... Ts>
+constexpr std::size_t declared_size()
+{
+    return size_in_order(members_of<Ts...>(), declared_order<sizeof...(Ts)>());
+}
+
+template <typename... Ts>
+constexpr std::array<std::size_t, sizeof...(Ts)> optimal_order()
+{
+    return optimal_order(members_of<Ts...>());
+}
+
+template <typename... Ts>
+constexpr std::size_t optimal_size()
+{
+    return size_in_order(members_of<Ts...>(), optimal_order<Ts...>());
+}
+
+// 2) real struct interface -----------------------------------------------
+
+template <std::size_t N>
+struct struct_info
+{
+    const char* name = "";
+    std::size_t size = 0;
+    std::size_t align = 1;
+    std::array<member_info, N> members{};
+
+    constexpr std::size_t used_bytes() const
+    {
+        std::size_t used = 0;
+        for (const auto& m : members)
+            used += m.size;
+        return used;
+    }
+
+    constexpr std::size_t padding() const { return size > used_bytes() ? size - used_bytes() : 0; }
+
+    // The order to suggest: the padding minimal one when that is smaller
+    // than the struct is now (it cannot be for a packed struct), else
+    // the declared one.
+    constexpr std::array<std::size_t, N> best_order() const
+    {
+        const auto order = optimal_order(members);
+        return size_in_order(members, order) < size ? order : declared_order<N>();
+    }
+
+    constexpr std::size_t optimal_size() const
+    {
+        const std::size_t reordered = size_in_order(members, optimal_order(members));
+        return reordered < size ? reordered : size;
+    }
+
+    // <= and not ==: a packed struct is allowed to be smaller still.
+    constexpr bool is_padding_minimal() const { return size <= size_in_order(members, optimal_order(members)); }
+
+    // The listed members account for the whole struct, i.e. none was
+    // forgotten: every member ends before the next one starts and no
+    // gap is larger than alignment alone explains. (A forgotten last
+    // member small enough to hide in the tail padding slips through.)
+    constexpr bool covers_struct() const
+    {
+        std::size_t end = 0;
+        for (std::size_t k = 0; k < N; ++k)
+        {
+            const auto& m = members[k];
+            if (m.offset < end)
+                return false;
+            if (m.offset - end >= m.align)
+                return false;   // a hole bigger than alignment needs: something in it
+            end = m.offset + m.size;
+        }
+        return size >= end && size - end < align;
+    }
+};
+
+template <typename T, typename... Members>
+constexpr struct_info<sizeof...(Members)> describe(const char* name, Members... members)
+{
+    return {name, sizeof(T), alignof(T), {members...}};
+}
+
+} // namespace layout
+
+// Describes one member of a standard layout struct for layout::describe.
+// The alignment is the one the member has in Type: a packed (or
+// #pragma pack) struct lowers it below the member type's own.
+#define LAYOUT_MEMBER(Type, member)                                                            \
+    ::layout::member_info                                                                      \
+    {                                                                                          \
+        #member, sizeof(Type::member),                                                         \
+            alignof(decltype(Type::member)) < alignof(Type) ? alignof(decltype(Type::member))  \
+                                                            : alignof(Type),                   \
+            offsetof(Type, member)                                                             \
+    }
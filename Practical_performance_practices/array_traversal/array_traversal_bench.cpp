@@ -0,0 +1,78 @@
+// Benchmarks for the claims in this folder:
+//
+// array_traversal.png / array_traversal.mdt
+//   row major traversal is much faster than column major.
+// array_traversal_1.png / array_traversal_1.mdt
+//   with some actual work per element (sqrt of a hash) the
+//   difference only shows up once the array outgrows the cache.
+// array_traversal_2.png / array_traversal_2_better.png
+//   two parallel vectors (foos[i], bars[i]) vs one vector of
+//   FooBar where the data used together also sits together.
+
+#include "bench.h"
+#include "foo_bar.h"
+#include "traversal_kernels.h"
+
+#include <cstdint>
+#include <numeric>
+#include <random>
+#include <vector>
+
+// The classes from array_traversal_2.png
+int main(int argc, char** argv)
+{
+    bench::runner r("array_traversal", argc, argv);
+
+    {
+        const int n = r.size(4096, 256);
+        std::vector<int> array(static_cast<std::size_t>(n) * n, 1);
+        const std::size_t items = array.size();
+
+        r.run("traversal", "column_major", items, [&] { column_major(array, n); });
+        r.run("traversal", "row_major", items, [&] { row_major(array, n); });
+
+        r.run("traversal+work", "column_major", items, [&] { column_major_work(array, n); });
+        r.run("traversal+work", "row_major", items, [&] { row_major_work(array, n); });
+        bench::do_not_optimize(array.data());
+    }
+
+    {
+        const std::size_t count = r.size<std::size_t>(1 << 21, 1 << 12);
+        std::vector<Foo> foos(count);
+        std::vector<Bar> bars(count);
+        std::vector<FooBar> foobars(count);
+        for (std::size_t i = 0; i < count; ++i)
+        {
+            bars[i] = {i, i * 3, i * 7};
+            foobars[i].bar = bars[i];
+        }
+
+        r.run("parallel_vs_together", "foos[i],bars[i]", count, [&] {
+            for (std::size_t i = 0; i < count; ++i)
+                doSomething(foos[i], bars[i]);
+        });
+        r.run("parallel_vs_together", "foobars[i]", count, [&] {
+            for (std::size_t i = 0; i < count; ++i)
+                doSomething(foobars[i]);
+        });
+
+        // Same work visiting the elements in a random order: now every
+        // element costs a cache miss per vector it lives in.
+        std::vector<std::uint32_t> order(count);
+        std::iota(order.begin(), order.end(), 0u);
+        std::shuffle(order.begin(), order.end(), std::mt19937(42));
+
+        r.run("parallel_vs_together_random", "foos[i],bars[i]", count, [&] {
+            for (auto i : order)
+                doSomething(foos[i], bars[i]);
+        });
+        r.run("parallel_vs_together_random", "foobars[i]", count, [&] {
+            for (auto i : order)
+                doSomething(foobars[i]);
+        });
+        bench::do_not_optimize(foos.data());
+        bench::do_not_optimize(foobars.data());
+    }
+
+    return r.finish();
+}
@@ -0,0 +1,197 @@
+// Cache hierarchy sweep for the kernel of array_traversal_1.png:
+//
+//   array[i][j] += std::sqrt(std::hash<int>()(j*n + i));
+//
+// array_traversal_1.mdt says that for small arrays row major and
+// column major cost about the same (the loop is bound by the sqrt,
+// i.e. by computation) and only once the array outgrows the cache
+// does column major fall behind (bound by memory, the CPU waits for
+// data). Instead of one screenshot, this walks n from an array that
+// fits in a quarter of L1 up to many times the last level cache and
+// prints ns/element of both traversals as CSV, ready to be plotted
+// against `bytes` on a log axis. The `fits_in` column tells which
+// level of the (detected) hierarchy the array fits in, so the knee
+// can be read off directly. Where the hardware counters can be read
+// (perf_counters.h), IPC and LLC misses per element of both traversals
+// are added, which shows the switch from computation to waiting for
+// data directly; the columns stay empty otherwise.
+//
+// usage: array_traversal_sweep [--steps N] [--llc-multiple M]
+//                              [--max-bytes B] [--reps N] [--csv PATH] [--quick]
+//   --steps         sizes per doubling of the array size (default 2)
+//   --llc-multiple  largest array, in multiples of the LLC (default 8)
+//   --max-bytes     hard cap on the largest array (default 1 GiB)
+//   --reps          measured repetitions per size and traversal (default 5)
+//   --csv           write the CSV to PATH instead of stdout
+
+#include "bench.h"
+#include "cache_info.h"
+#include "perf_counters.h"
+#include "traversal_kernels.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+
+struct sweep_options
+{
+    int steps = 2;
+    double llc_multiple = 8;
+    std::size_t max_bytes = std::size_t(1) << 30;
+    int reps = 5;
+    std::string csv;
+    bool quick = false;
+};
+
+sweep_options parse(int argc, char** argv)
+{
+    sweep_options opt;
+    for (int i = 1; i < argc; ++i)
+    {
+        const std::string arg = argv[i];
+        auto next = [&]() -> const char* {
+            if (i + 1 >= argc)
+            {
+                std::cerr << "missing value for " << arg << '\n';
+                std::exit(2);
+            }
+            return argv[++i];
+        };
+        if (arg == "--steps")
+            opt.steps = std::max(1, std::atoi(next()));
+        else if (arg == "--llc-multiple")
+            opt.llc_multiple = std::max(1.0, std::atof(next()));
+        else if (arg == "--max-bytes")
+            opt.max_bytes = std::strtoull(next(), nullptr, 10);
+        else if (arg == "--reps")
+            opt.reps = std::max(1, std::atoi(next()));
+        else if (arg == "--csv")
+            opt.csv = next();
+        else if (arg == "--quick")
+            opt.quick = true;
+        else
+        {
+            std::cerr << "usage: " << argv[0]
+                      << " [--steps N] [--llc-multiple M] [--max-bytes B] [--reps N] [--csv PATH] [--quick]\n";
+            std::exit(arg == "--help" || arg == "-h" ? 0 : 2);
+        }
+    }
+    return opt;
+}
+
+// Small arrays run in microseconds, far too close to the timer
+// resolution, so each sample repeats the traversal until at least
+// `min_elements` elements have been processed. Repeating on the same
+// array is intended: it stays in whatever cache it fits in.
+struct sweep_point
+{
+    bench::stats ns;   // per element
+    std::string ipc;   // empty when not counted
+    std::string llc_misses;
+};
+
+template <typename Kernel>
+sweep_point measure(Kernel kernel, std::vector<int>& array, int n, int reps, bench::perf_counters& counters)
+{
+    const std::size_t elements = static_cast<std::size_t>(n) * n;
+    const std::size_t min_elements = std::size_t(1) << 22;
+    const std::size_t passes = std::max<std::size_t>(1, min_elements / elements);
+
+    kernel(array, n);   // warm-up: page in, fill the caches
+
+    std::vector<double> samples;
+    {
+        bench::perf_scope counting(counters);
+        for (int r = 0; r < reps; ++r)
+        {
+            const auto start = std::chrono::steady_clock::now();
+            for (std::size_t p = 0; p < passes; ++p)
+                kernel(array, n);
+            bench::clobber_memory();
+            const auto stop = std::chrono::steady_clock::now();
+            samples.push_back(std::chrono::duration<double, std::nano>(stop - start).count() /
+                              static_cast<double>(passes * elements));
+        }
+    }
+
+    sweep_point point;
+    point.ns = bench::summarize(std::move(samples));
+    using bench::counter;
+    if (counters.available(counter::cycles) && counters.available(counter::instructions) &&
+        counters.value(counter::cycles) > 0)
+        point.ipc = std::to_string(counters.value(counter::instructions) / counters.value(counter::cycles));
+    if (counters.available(counter::llc_misses))
+        point.llc_misses = std::to_string(counters.value(counter::llc_misses) /
+                                          (static_cast<double>(reps) * passes * elements));
+    return point;
+}
+
+int main(int argc, char** argv)
+{
+    const auto opt = parse(argc, argv);
+    const auto caches = bench::detect_caches();
+
+    std::cerr << "caches (" << caches.source << "):";
+    for (const auto& level : caches.levels)
+        std::cerr << " L" << level.level << "=" << (level.size >> 10) << "KiB";
+    std::cerr << '\n';
+
+    const std::size_t l1 = caches.size(1) ? caches.size(1) : (32u << 10);
+    const std::size_t llc = caches.last_level_size() ? caches.last_level_size() : (8u << 20);
+    const double first_bytes = l1 / 4.0;
+    double last_bytes = std::min(static_cast<double>(opt.max_bytes), llc * opt.llc_multiple);
+    if (opt.quick)
+        last_bytes = std::min(last_bytes, 4.0 * l1);
+    // i * n + j has to fit in an int
+    last_bytes = std::min(last_bytes, 46340.0 * 46340.0 * sizeof(int));
+
+    std::ofstream file;
+    if (!opt.csv.empty())
+    {
+        file.open(opt.csv);
+        if (!file)
+        {
+            std::cerr << "cannot write " << opt.csv << '\n';
+            return 1;
+        }
+    }
+    std::ostream& out = opt.csv.empty() ? std::cout : file;
+
+    out << "n,bytes,fits_in,row_major_ns_per_element,row_major_p99,"
+           "column_major_ns_per_element,column_major_p99,column_over_row,"
+           "row_major_ipc,row_major_llc_misses_per_element,"
+           "column_major_ipc,column_major_llc_misses_per_element\n";
+
+    bench::perf_counters counters;
+
+    int previous_n = 0;
+    const double factor = std::pow(2.0, 1.0 / opt.steps);
+    for (double bytes = first_bytes; bytes <= last_bytes * 1.0001; bytes *= factor)
+    {
+        const int n = static_cast<int>(std::sqrt(bytes / sizeof(int)));
+        if (n <= previous_n)
+            continue;
+        previous_n = n;
+
+        std::vector<int> array(static_cast<std::size_t>(n) * n, 1);
+        const std::size_t array_bytes = array.size() * sizeof(int);
+        const auto row = measure(row_major_work, array, n, opt.reps, counters);
+        const auto column = measure(column_major_work, array, n, opt.reps, counters);
+        bench::do_not_optimize(array.data());
+
+        out << n << ',' << array_bytes << ',' << caches.fits_in(array_bytes) << ','
+            << row.ns.median << ',' << row.ns.p99 << ','
+            << column.ns.median << ',' << column.ns.p99 << ','
+            << column.ns.median / row.ns.median << ','
+            << row.ipc << ',' << row.llc_misses << ','
+            << column.ipc << ',' << column.llc_misses << '\n';
+        out.flush();
+    }
+    return 0;
+}
@@ -0,0 +1,38 @@
+#pragma once
+
+// The records from array_traversal_2.png and array_traversal_2_better.png.
+
+#include <cstdint>
+
+struct Foo
+{
+    char c;
+    double d;
+    short s;
+    int i;
+};
+
+struct Bar
+{
+    std::uint64_t lo;
+    std::uint64_t mid;
+    std::uint64_t hi;
+};
+
+// array_traversal_2_better.png: stick it together
+struct FooBar
+{
+    Foo foo;
+    Bar bar;
+};
+
+inline void doSomething(Foo& foo, const Bar& bar)
+{
+    foo.d += static_cast<double>(bar.lo ^ bar.hi);
+    foo.i += static_cast<int>(bar.mid);
+}
+
+inline void doSomething(FooBar& foobar)
+{
+    doSomething(foobar.foo, foobar.bar);
+}
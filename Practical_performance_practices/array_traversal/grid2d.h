@@ -0,0 +1,219 @@
+#pragma once
+
+// Grid2D<T>: a dense rows x cols grid stored row major in one
+// contiguous allocation, with a tiled (cache blocked) traversal engine.
+//
+// Why: array_traversal.png shows that walking a row major array
+// column by column is slow, because every step jumps a whole row
+// ahead and lands on a new cache line; by the time we come back for
+// the neighbouring element that line has long been evicted. Some
+// workloads are column wise by nature (per column reductions,
+// transposes, stencils along the other axis), so "just go row major"
+// is not always an option.
+//
+// Tiling fixes that: the grid is cut into tile_rows x tile_cols
+// blocks small enough to stay in L1/L2, and the traversal finishes
+// one block before moving to the next. Inside a block we may walk
+// column wise and every cache line we touch is reused before eviction.
+//
+// The blocks themselves can be visited in row major order or in
+// Morton (Z) order. Z order keeps consecutive blocks close in both
+// directions, which helps when a kernel also touches the neighbouring
+// blocks (or a second grid, as in transpose).
+//
+// Picking the tile shape for column walks: rows a power of two bytes
+// apart map to the same L1 set, so a tall tile over a 4096 wide grid
+// only gets as many lines as the cache has ways (8-12) before it starts
+// evicting its own data. Keep tile_rows at or below the L1
+// associativity (8 is safe) and make the tile wide instead.
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+enum class tile_order
+{
+    row_major,   // tile (0,0), (0,1), ... (1,0), (1,1), ...
+    morton       // Z order: (0,0), (0,1), (1,0), (1,1), (0,2), ...
+};
+
+enum class tile_walk
+{
+    rows,        // inside a tile: row by row
+    columns      // inside a tile: column by column
+};
+
+struct tile_options
+{
+    std::size_t tile_rows = 64;
+    std::size_t tile_cols = 64;
+    tile_order order = tile_order::row_major;
+    tile_walk walk = tile_walk::rows;
+};
+
+namespace grid_detail {
+
+// Extracts the even bits of x (x = ...b4b3b2b1b0 -> b4b2b0).
+inline std::uint32_t compact_bits(std::uint64_t x)
+{
+    x &= 0x5555555555555555ull;
+    x = (x | (x >> 1)) & 0x3333333333333333ull;
+    x = (x | (x >> 2)) & 0x0f0f0f0f0f0f0f0full;
+    x = (x | (x >> 4)) & 0x00ff00ff00ff00ffull;
+    x = (x | (x >> 8)) & 0x0000ffff0000ffffull;
+    x = (x | (x >> 16)) & 0x00000000ffffffffull;
+    return static_cast<std::uint32_t>(x);
+}
+
+// Morton code -> (row, col): odd bits are the row, even bits the column.
+inline void morton_decode(std::uint64_t code, std::size_t& row, std::size_t& col)
+{
+    col = compact_bits(code);
+    row = compact_bits(code >> 1);
+}
+
+} // namespace grid_detail
+
+template <typename T>
+class Grid2D
+{
+  public:
+    Grid2D() = default;
+    Grid2D(std::size_t rows, std::size_t cols, const T& value = T())
+        : m_rows(rows), m_cols(cols), m_data(rows * cols, value)
+    {
+    }
+
+    std::size_t rows() const { return m_rows; }
+    std::size_t cols() const { return m_cols; }
+    std::size_t size() const { return m_data.size(); }
+
+    T& operator()(std::size_t row, std::size_t col) { return m_data[row * m_cols + col]; }
+    const T& operator()(std::size_t row, std::size_t col) const { return m_data[row * m_cols + col]; }
+
+    T* data() { return m_data.data(); }
+    const T* data() const { return m_data.data(); }
+    T* row(std::size_t r) { return m_data.data() + r * m_cols; }
+    const T* row(std::size_t r) const { return m_data.data() + r * m_cols; }
+
+    // Visits every tile (as [row_begin, row_end) x [col_begin, col_end))
+    // exactly once in the requested order. The building block for the
+    // element wise traversals below and for two-grid kernels like transpose.
+    template <typename F>
+    void for_each_tile(F&& f, const tile_options& opt = {}) const
+    {
+        const std::size_t tr = std::max<std::size_t>(1, opt.tile_rows);
+        const std::size_t tc = std::max<std::size_t>(1, opt.tile_cols);
+        const std::size_t tiles_down = (m_rows + tr - 1) / tr;
+        const std::size_t tiles_across = (m_cols + tc - 1) / tc;
+
+        auto visit = [&](std::size_t ty, std::size_t tx) {
+            const std::size_t r0 = ty * tr, c0 = tx * tc;
+            f(r0, std::min(r0 + tr, m_rows), c0, std::min(c0 + tc, m_cols));
+        };
+
+        if (opt.order == tile_order::row_major)
+        {
+            for (std::size_t ty = 0; ty < tiles_down; ++ty)
+                for (std::size_t tx = 0; tx < tiles_across; ++tx)
+                    visit(ty, tx);
+            return;
+        }
+
+        // Morton: walk the codes of the enclosing power of two square
+        // and skip the ones that fall outside of the grid.
+        std::size_t side = 1;
+        while (side < tiles_down || side < tiles_across)
+            side <<= 1;
+        const std::uint64_t codes = static_cast<std::uint64_t>(side) * side;
+        for (std::uint64_t code = 0; code < codes; ++code)
+        {
+            std::size_t ty, tx;
+            grid_detail::morton_decode(code, ty, tx);
+            if (ty < tiles_down && tx < tiles_across)
+                visit(ty, tx);
+        }
+    }
+
+    // f(T& value, std::size_t row, std::size_t col) for every element,
+    // tile by tile. The result is the same as for a plain loop as long as
+    // f only depends on (row, col) and the element itself.
+    template <typename F>
+    void for_each_tiled(F&& f, const tile_options& opt = {})
+    {
+        const std::size_t cols = m_cols;
+        T* const base = m_data.data();
+        for_each_tile(
+            [&](std::size_t r0, std::size_t r1, std::size_t c0, std::size_t c1) {
+                if (opt.walk == tile_walk::rows)
+                {
+                    for (std::size_t r = r0; r < r1; ++r)
+                        for (std::size_t c = c0; c < c1; ++c)
+                            f(base[r * cols + c], r, c);
+                }
+                else
+                {
+                    for (std::size_t c = c0; c < c1; ++c)
+                        for (std::size_t r = r0; r < r1; ++r)
+                            f(base[r * cols + c], r, c);
+                }
+            },
+            opt);
+    }
+
+    // The untiled loops, for comparison and for small grids.
+    template <typename F>
+    void for_each_row_major(F&& f)
+    {
+        for (std::size_t r = 0; r < m_rows; ++r)
+            for (std::size_t c = 0; c < m_cols; ++c)
+                f(m_data[r * m_cols + c], r, c);
+    }
+
+    template <typename F>
+    void for_each_column_major(F&& f)
+    {
+        for (std::size_t c = 0; c < m_cols; ++c)
+            for (std::size_t r = 0; r < m_rows; ++r)
+                f(m_data[r * m_cols + c], r, c);
+    }
+
+  private:
+    std::size_t m_rows = 0;
+    std::size_t m_cols = 0;
+    std::vector<T> m_data;
+};
+
+// dst = transpose(src), tile by tile: each tile reads a block of rows
+// of src and writes a block of columns of dst, both small enough to
+// stay cached. dst is resized when needed.
+template <typename T>
+void transpose(const Grid2D<T>& src, Grid2D<T>& dst, const tile_options& opt = {})
+{
+    if (dst.rows() != src.cols() || dst.cols() != src.rows())
+        dst = Grid2D<T>(src.cols(), src.rows());
+
+    src.for_each_tile(
+        [&](std::size_t r0, std::size_t r1, std::size_t c0, std::size_t c1) {
+            for (std::size_t r = r0; r < r1; ++r)
+            {
+                const T* in = src.row(r);
+                for (std::size_t c = c0; c < c1; ++c)
+                    dst(c, r) = in[c];
+            }
+        },
+        opt);
+}
+
+// The naive version: streams through src, strides through dst.
+template <typename T>
+void transpose_naive(const Grid2D<T>& src, Grid2D<T>& dst)
+{
+    if (dst.rows() != src.cols() || dst.cols() != src.rows())
+        dst = Grid2D<T>(src.cols(), src.rows());
+
+    for (std::size_t r = 0; r < src.rows(); ++r)
+        for (std::size_t c = 0; c < src.cols(); ++c)
+            dst(c, r) = src(r, c);
+}
@@ -0,0 +1,84 @@
+// Benchmark of the tiled traversal engine of Grid2D (grid2d.h) against
+// the naive column major loop of array_traversal_1.png:
+//
+//   for i: for j: array[j][i] += std::sqrt(std::hash<int>()(i*n + j));
+//
+// Every variant computes exactly the same grid (checked below), only
+// the order in which the elements are visited differs. The tiled
+// column walk is the interesting one: it is still a column by column
+// walk, just confined to a block, and should close most of the gap
+// to the row major loop for large n. The 64 x 64 tile is there to
+// show the cache set aliasing described in grid2d.h; the 8 x 256 tile
+// is the one to use. Transpose is the classic
+// workload that cannot be made row major for both grids at once.
+
+#include "bench.h"
+#include "grid2d.h"
+#include "traversal_kernels.h"
+
+#include <cmath>
+#include <cstdio>
+#include <functional>
+#include <vector>
+
+int main(int argc, char** argv)
+{
+    bench::runner r("grid2d", argc, argv);
+
+    const int n = r.size(4096, 256);
+    const std::size_t items = static_cast<std::size_t>(n) * n;
+
+    // Value of element (row, col) in the kernel of array_traversal_1.png.
+    auto work = [n](int& value, std::size_t row, std::size_t col) {
+        value += std::sqrt(std::hash<int>()(static_cast<int>(col * n + row)));
+    };
+
+    std::vector<int> array(items, 1);
+    Grid2D<int> grid(n, n, 1);
+
+    r.run("sqrt_hash", "naive_column_major", items, [&] { column_major_work(array, n); });
+    r.run("sqrt_hash", "naive_row_major", items, [&] { row_major_work(array, n); });
+    r.run("sqrt_hash", "grid_column_major", items, [&] { grid.for_each_column_major(work); });
+
+    tile_options opt;
+    opt.walk = tile_walk::columns;
+    r.run("sqrt_hash", "tiled_64x64_columns", items, [&] { grid.for_each_tiled(work, opt); });
+    opt.tile_rows = 8;
+    opt.tile_cols = 256;
+    r.run("sqrt_hash", "tiled_8x256_columns", items, [&] { grid.for_each_tiled(work, opt); });
+    opt.order = tile_order::morton;
+    r.run("sqrt_hash", "tiled_8x256_columns_morton", items, [&] { grid.for_each_tiled(work, opt); });
+    opt.order = tile_order::row_major;
+    opt.walk = tile_walk::rows;
+    r.run("sqrt_hash", "tiled_8x256_rows", items, [&] { grid.for_each_tiled(work, opt); });
+
+    // Same kernel, same starting values: both must end up identical.
+    std::vector<int> check_array(items, 1);
+    Grid2D<int> check_grid(n, n, 1);
+    column_major_work(check_array, n);
+    opt.walk = tile_walk::columns;
+    opt.order = tile_order::morton;
+    check_grid.for_each_tiled(work, opt);
+    for (std::size_t k = 0; k < items; ++k)
+        if (check_array[k] != check_grid.data()[k])
+        {
+            std::fprintf(stderr, "tiled traversal differs from the naive one at %zu\n", k);
+            return 1;
+        }
+
+    Grid2D<int> transposed;
+    r.run("transpose", "naive", items, [&] { transpose_naive(grid, transposed); });
+    tile_options square;
+    for (std::size_t tile : {16, 32, 64})
+    {
+        square.tile_rows = square.tile_cols = tile;
+        square.order = tile_order::row_major;
+        r.run("transpose", "tiled_" + std::to_string(tile), items, [&] { transpose(grid, transposed, square); });
+        square.order = tile_order::morton;
+        r.run("transpose", "tiled_" + std::to_string(tile) + "_morton", items,
+              [&] { transpose(grid, transposed, square); });
+    }
+    bench::do_not_optimize(transposed.data());
+
+    return r.finish();
+}
@@ -0,0 +1,118 @@
+// Scaling of the row major traversal with the number of cores
+// (parallel_traversal.h).
+//
+//   add        array[i][j] += j (array_traversal.png): 8 bytes of memory
+//              traffic per element and almost no work, so it shows where
+//              the memory bandwidth saturates. Its GB/s (8 bytes per
+//              element over the median time) is printed per thread count
+//              after the runs.
+//   sqrt_hash  the vectorized "+ some work" kernel (sqrt_hash_simd.h):
+//              compute bound, should keep scaling with the cores.
+//
+// For every thread count 1, 2, 4, ... up to the machine (--max-threads=N
+// to cap it) a pinned pool and a first touch grid are built, so each
+// worker traverses the rows it initialized. The speedup column is
+// relative to one thread. Two more groups at the full thread count
+// compare first touch with a grid filled by the main thread, and the
+// pool with std::execution::par (when the standard library has a
+// parallel backend, see CMakeLists.txt). --pin=0 disables pinning.
+
+#include "bench.h"
+#include "parallel_traversal.h"
+#include "sqrt_hash_simd.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <numeric>
+#include <string>
+#include <vector>
+
+#ifdef PARALLEL_TRAVERSAL_HAS_EXECUTION
+#include <execution>
+#endif
+
+void add_rows(first_touch_grid<int>& grid, std::size_t r0, std::size_t r1)
+{
+    const std::size_t cols = grid.cols();
+    for (std::size_t r = r0; r < r1; ++r)
+    {
+        int* row = grid.row(r);
+        for (std::size_t c = 0; c < cols; ++c)
+            row[c] += static_cast<int>(c);
+    }
+}
+
+int main(int argc, char** argv)
+{
+    bench::runner r("parallel", argc, argv);
+
+    const std::size_t n = r.size<std::size_t>(8192, 512);
+    const std::size_t items = n * n;
+    const bool pin = r.param("pin", 1) != 0;
+    const unsigned machine = static_cast<unsigned>(bench::available_cpus().size());
+    // clamped before any name is built from it: a pool has at least one thread
+    const auto max_threads =
+        static_cast<unsigned>(std::clamp<long>(r.param("max-threads", machine), 1, std::max(1u, machine)));
+
+    std::vector<unsigned> counts;
+    for (unsigned t = 1; t < max_threads; t *= 2)
+        counts.push_back(t);
+    counts.push_back(max_threads);
+
+    for (unsigned threads : counts)
+    {
+        bench::pinned_pool pool(threads, pin);
+        first_touch_grid<int> grid(pool, n, n, 1);
+        const std::string name = "threads_" + std::to_string(threads);
+        r.run("add", name, items, [&] {
+            parallel_for_rows(pool, n, [&](std::size_t r0, std::size_t r1) { add_rows(grid, r0, r1); });
+        });
+        r.run("sqrt_hash", name, items, [&] {
+            parallel_for_rows(pool, n, [&](std::size_t r0, std::size_t r1) {
+                sqrt_hash_rows(grid.data(), static_cast<int>(n), static_cast<int>(r0), static_cast<int>(r1));
+            });
+        });
+        bench::do_not_optimize(grid.data());
+    }
+
+    {
+        bench::pinned_pool pool(max_threads, pin);
+        const std::string name = "_threads_" + std::to_string(max_threads);
+
+        first_touch_grid<int> serial_grid(n, n, 1);
+        r.run("placement", "main_thread_init" + name, items, [&] {
+            parallel_for_rows(pool, n, [&](std::size_t r0, std::size_t r1) { add_rows(serial_grid, r0, r1); });
+        });
+        first_touch_grid<int> local_grid(pool, n, n, 1);
+        r.run("placement", "first_touch" + name, items, [&] {
+            parallel_for_rows(pool, n, [&](std::size_t r0, std::size_t r1) { add_rows(local_grid, r0, r1); });
+        });
+
+#ifdef PARALLEL_TRAVERSAL_HAS_EXECUTION
+        // One chunk of rows per element handed to the algorithm; the
+        // library decides how many threads and which thread gets what.
+        const std::size_t chunks = std::min<std::size_t>(n, 4 * max_threads);
+        std::vector<std::size_t> chunk_ids(chunks);
+        std::iota(chunk_ids.begin(), chunk_ids.end(), std::size_t(0));
+        r.run("pool_vs_std_par", "pinned_pool" + name, items, [&] {
+            parallel_for_rows(pool, n, [&](std::size_t r0, std::size_t r1) { add_rows(local_grid, r0, r1); });
+        });
+        r.run("pool_vs_std_par", "std::execution::par", items, [&] {
+            std::for_each(std::execution::par, chunk_ids.begin(), chunk_ids.end(), [&](std::size_t chunk) {
+                const auto range = rows_of(static_cast<unsigned>(chunk), static_cast<unsigned>(chunks), n);
+                add_rows(local_grid, range.begin, range.end);
+            });
+        });
+#endif
+        bench::do_not_optimize(serial_grid.data());
+        bench::do_not_optimize(local_grid.data());
+    }
+
+    // one int read and written per element
+    std::printf("  add bandwidth:");
+    for (const auto& result : r.results())
+        if (result.group == "add")
+            std::printf("  %s %.1f GB/s", result.name.c_str(), 8.0 * result.items / result.ns.median);
+    std::printf("\n");
+    return r.finish();
+}
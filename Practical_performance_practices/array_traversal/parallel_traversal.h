@@ -0,0 +1,86 @@
+#pragma once
+
+// Row partitioned parallel traversal of a row major grid.
+//
+// One thread walking a big grid in row major order is limited by how
+// many cache misses a single core can have in flight, which is a small
+// part of what the memory system can deliver. Splitting the rows into
+// one contiguous block per thread keeps every thread streaming (row
+// major, as array_traversal.png says) while adding cores adds bandwidth,
+// up to the point where the memory controllers are saturated.
+//
+// Two details matter on big machines:
+//
+// * Thread pinning. bench::pinned_pool (benchmark/pinned_pool.h) keeps
+//   worker w on CPU w (of the CPUs this process may run on), so the OS
+//   does not migrate it away from its caches and its memory.
+//
+// * First touch. Linux places a page on the NUMA node of the thread
+//   that first writes it, not the one that allocated it. A grid filled
+//   by the main thread lives entirely on one node and every other
+//   socket reads it over the interconnect. first_touch_grid allocates
+//   without initializing (make_unique_for_overwrite) and lets every
+//   worker initialize exactly the rows it will later traverse.
+
+#include "pinned_pool.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <memory>
+
+// Rows [begin, end) of worker `w` out of `workers`, as even as possible.
+struct row_range
+{
+    std::size_t begin;
+    std::size_t end;
+};
+
+inline row_range rows_of(unsigned w, unsigned workers, std::size_t rows)
+{
+    return {rows * w / workers, rows * (w + 1) / workers};
+}
+
+// f(row_begin, row_end) on every worker, each with its own block of rows.
+template <typename F>
+void parallel_for_rows(bench::pinned_pool& pool, std::size_t rows, F&& f)
+{
+    const unsigned workers = pool.size();
+    pool.run([&](unsigned w) {
+        const auto range = rows_of(w, workers, rows);
+        f(range.begin, range.end);
+    });
+}
+
+// An n x n row major grid whose pages are first touched by the workers
+// that own the rows. Traverse it with the same pool (same partition)
+// to keep every thread on its local memory.
+template <typename T>
+class first_touch_grid
+{
+  public:
+    // Rows initialized by the pool's workers.
+    first_touch_grid(bench::pinned_pool& pool, std::size_t rows, std::size_t cols, const T& value)
+        : m_rows(rows), m_cols(cols), m_data(std::make_unique_for_overwrite<T[]>(rows * cols))
+    {
+        parallel_for_rows(pool, rows, [&](std::size_t r0, std::size_t r1) {
+            std::fill(row(r0), row(r1), value);
+        });
+    }
+
+    // Everything initialized by the calling thread: the "before".
+    first_touch_grid(std::size_t rows, std::size_t cols, const T& value)
+        : m_rows(rows), m_cols(cols), m_data(std::make_unique_for_overwrite<T[]>(rows * cols))
+    {
+        std::fill(row(0), row(rows), value);
+    }
+
+    std::size_t rows() const { return m_rows; }
+    std::size_t cols() const { return m_cols; }
+    T* data() { return m_data.get(); }
+    T* row(std::size_t r) { return m_data.get() + r * m_cols; }
+
+  private:
+    std::size_t m_rows;
+    std::size_t m_cols;
+    std::unique_ptr<T[]> m_data;
+};
@@ -0,0 +1,72 @@
+// Scalar vs auto-vectorized vs hand vectorized versions of the row
+// major "+ some work" loop of array_traversal_1.png (sqrt_hash_simd.h).
+//
+//   scalar_std_hash    the loop from the slide, std::hash<int> + double sqrt
+//   scalar_hash32      the vectorizable hash, vectorization disabled
+//   auto               the same loop, auto-vectorized for the build target
+//   auto_avx2          the same loop, auto-vectorized with AVX2 enabled
+//   avx2 / avx512      hand written intrinsics (skipped if unsupported)
+//   dispatched         runtime pick, what callers should use
+//
+// Every hash32 variant must produce the same grid; checked below.
+// sqrt_hash_simd.cpp is built with -fno-math-errno: otherwise std::sqrt
+// has to be able to set errno for negative inputs, and that alone stops
+// the auto-vectorizer.
+
+#include "bench.h"
+#include "sqrt_hash_simd.h"
+#include "traversal_kernels.h"
+
+#include <cstdio>
+#include <string>
+#include <vector>
+
+int main(int argc, char** argv)
+{
+    bench::runner r("simd", argc, argv);
+
+    const simd_level level = detect_simd_level();
+    std::printf("# best SIMD level on this machine: %s\n", to_string(level));
+
+    // in cache (compute bound) and far out of it (memory bound)
+    for (int n : {r.size(256, 64), r.size(4096, 256)})
+    {
+        const std::string group = "sqrt_hash_n" + std::to_string(n);
+        const std::size_t items = static_cast<std::size_t>(n) * n;
+        std::vector<int> array(items, 1);
+
+        r.run(group, "scalar_std_hash", items, [&] { row_major_work(array, n); });
+        r.run(group, "scalar_hash32", items, [&] { sqrt_hash_reference(array.data(), n); });
+        r.run(group, "auto", items, [&] { sqrt_hash_auto(array.data(), n); });
+        if (level != simd_level::portable)
+        {
+            r.run(group, "auto_avx2", items, [&] { sqrt_hash_auto_avx2(array.data(), n); });
+            r.run(group, "avx2", items, [&] { sqrt_hash_avx2(array.data(), n); });
+        }
+        if (level == simd_level::avx512)
+            r.run(group, "avx512", items, [&] { sqrt_hash_avx512(array.data(), n); });
+        r.run(group, "dispatched", items, [&] { sqrt_hash(array.data(), n); });
+        bench::do_not_optimize(array.data());
+
+        // odd n to also exercise the scalar tails
+        const int m = n + 3;
+        std::vector<int> expected(static_cast<std::size_t>(m) * m, 1);
+        sqrt_hash_reference(expected.data(), m);
+        const sqrt_hash_kernel kernels[] = {sqrt_hash_auto, sqrt_hash_auto_avx2, sqrt_hash_avx2,
+                                            sqrt_hash_avx512};
+        const std::size_t supported = level == simd_level::avx512 ? 4 : level == simd_level::avx2 ? 3 : 1;
+        for (std::size_t k = 0; k < supported; ++k)
+        {
+            const auto kernel = kernels[k];
+            std::vector<int> actual(expected.size(), 1);
+            kernel(actual.data(), m);
+            if (actual != expected)
+            {
+                std::fprintf(stderr, "a vectorized sqrt_hash kernel differs from the reference\n");
+                return 1;
+            }
+        }
+    }
+
+    return r.finish();
+}
@@ -0,0 +1,146 @@
+// AoS vs SoA vs AoSoA for the Foo/Bar records of array_traversal_2.png.
+//
+//   parallel  std::vector<Foo> + std::vector<Bar>   (array_traversal_2.png)
+//   AoS       std::vector<FooBar>                   (array_traversal_2_better.png)
+//   SoA       soa_vector<...> one array per member  (soa_vector.h)
+//   AoSoA     blocks of 8 records, one small array per member inside
+//             each block, so a record is still "together" (one or two
+//             cache lines per member group) while a member is contiguous
+//             for 8 records at a time.
+//
+// Three hot loops: one that reads a single member, one that touches
+// two and one that uses (nearly) the whole record. SoA should win the
+// first two by streaming only the bytes it needs; the full record
+// loop is where AoS catches up.
+
+#include "bench.h"
+#include "foo_bar.h"
+#include "soa_vector.h"
+
+#include <cstdint>
+#include <vector>
+
+enum foobar_field { c, d, s, i, lo, mid, hi };
+using FooBarSoA = soa_vector<char, double, short, int, std::uint64_t, std::uint64_t, std::uint64_t>;
+
+constexpr std::size_t lanes = 8;
+struct FooBarBlock
+{
+    char c[lanes];
+    short s[lanes];
+    int i[lanes];
+    double d[lanes];
+    std::uint64_t lo[lanes];
+    std::uint64_t mid[lanes];
+    std::uint64_t hi[lanes];
+};
+
+int main(int argc, char** argv)
+{
+    bench::runner r("soa", argc, argv);
+
+    const std::size_t count = r.size<std::size_t>(1 << 22, 1 << 12);
+
+    std::vector<Foo> foos(count);
+    std::vector<Bar> bars(count);
+    std::vector<FooBar> foobars(count);
+    FooBarSoA soa;
+    soa.reserve(count);
+    std::vector<FooBarBlock> blocks((count + lanes - 1) / lanes);
+    for (std::size_t k = 0; k < count; ++k)
+    {
+        const Foo foo{static_cast<char>(k), k * 0.5, static_cast<short>(k), static_cast<int>(k)};
+        const Bar bar{k, k * 3, k * 7};
+        foos[k] = foo;
+        bars[k] = bar;
+        foobars[k] = {foo, bar};
+        soa.push_back(foo.c, foo.d, foo.s, foo.i, bar.lo, bar.mid, bar.hi);
+        auto& block = blocks[k / lanes];
+        const auto l = k % lanes;
+        block.c[l] = foo.c;
+        block.s[l] = foo.s;
+        block.i[l] = foo.i;
+        block.d[l] = foo.d;
+        block.lo[l] = bar.lo;
+        block.mid[l] = bar.mid;
+        block.hi[l] = bar.hi;
+    }
+
+    // one member: sum of d -------------------------------------------------
+    r.run("one_field_sum_d", "parallel", count, [&] {
+        double sum = 0;
+        for (const auto& foo : foos)
+            sum += foo.d;
+        bench::do_not_optimize(sum);
+    });
+    r.run("one_field_sum_d", "AoS", count, [&] {
+        double sum = 0;
+        for (const auto& foobar : foobars)
+            sum += foobar.foo.d;
+        bench::do_not_optimize(sum);
+    });
+    r.run("one_field_sum_d", "SoA", count, [&] {
+        double sum = 0;
+        for (double x : soa.field<d>())
+            sum += x;
+        bench::do_not_optimize(sum);
+    });
+    r.run("one_field_sum_d", "AoSoA", count, [&] {
+        double sum = 0;
+        for (const auto& block : blocks)
+            for (std::size_t l = 0; l < lanes; ++l)
+                sum += block.d[l];
+        bench::do_not_optimize(sum);
+    });
+
+    // two members: i += mid ----------------------------------------------
+    r.run("two_fields_i+=mid", "parallel", count, [&] {
+        for (std::size_t k = 0; k < count; ++k)
+            foos[k].i += static_cast<int>(bars[k].mid);
+    });
+    r.run("two_fields_i+=mid", "AoS", count, [&] {
+        for (auto& foobar : foobars)
+            foobar.foo.i += static_cast<int>(foobar.bar.mid);
+    });
+    r.run("two_fields_i+=mid", "SoA", count, [&] {
+        auto is = soa.field<i>();
+        auto mids = soa.field<mid>();
+        for (std::size_t k = 0; k < count; ++k)
+            is[k] += static_cast<int>(mids[k]);
+    });
+    r.run("two_fields_i+=mid", "AoSoA", count, [&] {
+        for (auto& block : blocks)
+            for (std::size_t l = 0; l < lanes; ++l)
+                block.i[l] += static_cast<int>(block.mid[l]);
+    });
+
+    // (nearly) the whole record: doSomething -------------------------------
+    r.run("record_doSomething", "parallel", count, [&] {
+        for (std::size_t k = 0; k < count; ++k)
+            doSomething(foos[k], bars[k]);
+    });
+    r.run("record_doSomething", "AoS", count, [&] {
+        for (auto& foobar : foobars)
+            doSomething(foobar.foo, foobar.bar);
+    });
+    r.run("record_doSomething", "SoA_zipped", count, [&] {
+        for (auto [c_, d_, s_, i_, lo_, mid_, hi_] : soa)
+        {
+            d_ += static_cast<double>(lo_ ^ hi_);
+            i_ += static_cast<int>(mid_);
+        }
+    });
+    r.run("record_doSomething", "AoSoA", count, [&] {
+        for (auto& block : blocks)
+            for (std::size_t l = 0; l < lanes; ++l)
+            {
+                block.d[l] += static_cast<double>(block.lo[l] ^ block.hi[l]);
+                block.i[l] += static_cast<int>(block.mid[l]);
+            }
+    });
+
+    bench::do_not_optimize(foos.data());
+    bench::do_not_optimize(foobars.data());
+    bench::do_not_optimize(blocks.data());
+    return r.finish();
+}
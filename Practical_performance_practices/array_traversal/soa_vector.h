@@ -0,0 +1,158 @@
+#pragma once
+
+// soa_vector<Ts...>: a structure of arrays container.
+//
+// array_traversal_2.png keeps Foo{char, double, short, int} and
+// Bar{lo, mid, hi} in two parallel vectors and the note suggests to
+// "stick it together" (array_traversal_2_better.png). That is the
+// right call when a loop uses (almost) every member of the record. When
+// the hot loop only reads one or two members it is the opposite of
+// what we want: every cache line brought in is mostly filled with
+// members the loop never looks at (a double out of a 48 byte FooBar
+// is 1/6 of the bandwidth doing useful work).
+//
+// soa_vector stores each member (field) in its own contiguous array:
+//
+//   enum foobar_field { c, d, s, i, lo, mid, hi };
+//   soa_vector<char, double, short, int, std::uint64_t, std::uint64_t, std::uint64_t> v(n);
+//
+//   for (double& x : v.field<d>())          // only the doubles are streamed
+//       x *= 2;
+//
+//   for (auto [c, d, s, i, lo, mid, hi] : v)  // zipped access, references
+//       i += static_cast<int>(mid);           // into every field
+//
+// Element access (v[k], *it) returns a std::tuple of references, so it
+// works with structured bindings and std::get but is a proxy, not a
+// real object: there is no Foo to take the address of.
+
+#include <compare>
+#include <cstddef>
+#include <iterator>
+#include <span>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+template <typename... Ts>
+class soa_vector
+{
+    static_assert(sizeof...(Ts) > 0, "soa_vector needs at least one field");
+
+  public:
+    using reference = std::tuple<Ts&...>;
+    using const_reference = std::tuple<const Ts&...>;
+    using value_type = std::tuple<Ts...>;
+    static constexpr std::size_t field_count = sizeof...(Ts);
+
+    template <std::size_t I>
+    using field_type = std::tuple_element_t<I, std::tuple<Ts...>>;
+
+    soa_vector() = default;
+    explicit soa_vector(std::size_t count) { resize(count); }
+
+    std::size_t size() const { return std::get<0>(m_fields).size(); }
+    bool empty() const { return size() == 0; }
+
+    void resize(std::size_t count)
+    {
+        std::apply([count](auto&... field) { (field.resize(count), ...); }, m_fields);
+    }
+
+    void reserve(std::size_t count)
+    {
+        std::apply([count](auto&... field) { (field.reserve(count), ...); }, m_fields);
+    }
+
+    void clear()
+    {
+        std::apply([](auto&... field) { (field.clear(), ...); }, m_fields);
+    }
+
+    template <typename... Us>
+    void push_back(Us&&... values)
+    {
+        static_assert(sizeof...(Us) == sizeof...(Ts), "one value per field");
+        push_back_impl(std::index_sequence_for<Ts...>{}, std::forward<Us>(values)...);
+    }
+
+    // The contiguous array of one field.
+    template <std::size_t I>
+    std::span<field_type<I>> field()
+    {
+        return std::get<I>(m_fields);
+    }
+
+    template <std::size_t I>
+    std::span<const field_type<I>> field() const
+    {
+        return std::get<I>(m_fields);
+    }
+
+    reference operator[](std::size_t k)
+    {
+        return std::apply([k](auto&... field) { return reference(field[k]...); }, m_fields);
+    }
+
+    const_reference operator[](std::size_t k) const
+    {
+        return std::apply([k](const auto&... field) { return const_reference(field[k]...); }, m_fields);
+    }
+
+    template <bool Const>
+    class basic_iterator
+    {
+        using owner = std::conditional_t<Const, const soa_vector, soa_vector>;
+
+      public:
+        using iterator_category = std::random_access_iterator_tag;
+        using difference_type = std::ptrdiff_t;
+        using value_type = soa_vector::value_type;
+        using reference = std::conditional_t<Const, const_reference, soa_vector::reference>;
+        using pointer = void;
+
+        basic_iterator() = default;
+        basic_iterator(owner* v, std::size_t k) : m_v(v), m_k(k) {}
+
+        reference operator*() const { return (*m_v)[m_k]; }
+        reference operator[](difference_type n) const { return (*m_v)[m_k + n]; }
+
+        basic_iterator& operator++() { ++m_k; return *this; }
+        basic_iterator operator++(int) { auto tmp = *this; ++m_k; return tmp; }
+        basic_iterator& operator--() { --m_k; return *this; }
+        basic_iterator operator--(int) { auto tmp = *this; --m_k; return tmp; }
+        basic_iterator& operator+=(difference_type n) { m_k += n; return *this; }
+        basic_iterator& operator-=(difference_type n) { m_k -= n; return *this; }
+        friend basic_iterator operator+(basic_iterator it, difference_type n) { return it += n; }
+        friend basic_iterator operator+(difference_type n, basic_iterator it) { return it += n; }
+        friend basic_iterator operator-(basic_iterator it, difference_type n) { return it -= n; }
+        friend difference_type operator-(const basic_iterator& a, const basic_iterator& b)
+        {
+            return static_cast<difference_type>(a.m_k) - static_cast<difference_type>(b.m_k);
+        }
+        friend bool operator==(const basic_iterator& a, const basic_iterator& b) { return a.m_k == b.m_k; }
+        friend auto operator<=>(const basic_iterator& a, const basic_iterator& b) { return a.m_k <=> b.m_k; }
+
+      private:
+        owner* m_v = nullptr;
+        std::size_t m_k = 0;
+    };
+
+    using iterator = basic_iterator<false>;
+    using const_iterator = basic_iterator<true>;
+
+    iterator begin() { return {this, 0}; }
+    iterator end() { return {this, size()}; }
+    const_iterator begin() const { return {this, 0}; }
+    const_iterator end() const { return {this, size()}; }
+
+  private:
+    template <std::size_t... I, typename... Us>
+    void push_back_impl(std::index_sequence<I...>, Us&&... values)
+    {
+        (std::get<I>(m_fields).push_back(std::forward<Us>(values)), ...);
+    }
+
+    std::tuple<std::vector<Ts>...> m_fields;
+};
@@ -0,0 +1,240 @@
+#include "sqrt_hash_simd.h"
+
+#include <cmath>
+
+#if (defined(__x86_64__) || defined(__i386__)) && (defined(__GNUC__) || defined(__clang__))
+#define SQRT_HASH_X86 1
+#if defined(__GNUC__) && !defined(__clang__)
+// GCC 12 warns about the _mm512_undefined_* placeholders inside its
+// own AVX-512 headers (GCC bug 105593)
+#pragma GCC diagnostic ignored "-Wmaybe-uninitialized"
+#endif
+#include <immintrin.h>
+#endif
+
+namespace {
+
+inline void sqrt_hash_element(int* element, std::uint32_t index)
+{
+    const auto h = static_cast<float>(static_cast<std::int32_t>(hash32(index) >> 8));
+    *element = static_cast<int>(static_cast<float>(*element) + std::sqrt(h));
+}
+
+// The scalar tail (and the whole row, for the portable kernels).
+inline void sqrt_hash_row(int* row, int n, int i, int j_begin)
+{
+    for (int j = j_begin; j < n; ++j)
+        sqrt_hash_element(row + j, static_cast<std::uint32_t>(j) * n + i);
+}
+
+} // namespace
+
+const char* to_string(simd_level level)
+{
+    switch (level)
+    {
+    case simd_level::avx512: return "avx512";
+    case simd_level::avx2: return "avx2";
+    default: return "portable";
+    }
+}
+
+simd_level detect_simd_level()
+{
+#ifdef SQRT_HASH_X86
+    // also checks that the OS saves the wider registers (XCR0)
+    if (__builtin_cpu_supports("avx512f"))
+        return simd_level::avx512;
+    if (__builtin_cpu_supports("avx2"))
+        return simd_level::avx2;
+#endif
+    return simd_level::portable;
+}
+
+#if defined(__GNUC__) && !defined(__clang__)
+__attribute__((optimize("no-tree-vectorize")))
+#endif
+void sqrt_hash_reference(int* array, int n)
+{
+    // spelled out: a helper with different optimize options might not
+    // be inlined, and its out of line copy would be vectorized
+    for (int i = 0; i < n; ++i)
+        for (int j = 0; j < n; ++j)
+        {
+            int& element = array[static_cast<std::size_t>(i) * n + j];
+            const auto index = static_cast<std::uint32_t>(j) * n + i;
+            const auto h = static_cast<float>(static_cast<std::int32_t>(hash32(index) >> 8));
+            element = static_cast<int>(static_cast<float>(element) + std::sqrt(h));
+        }
+}
+
+namespace {
+
+using rows_kernel = void (*)(int* array, int n, int i_begin, int i_end);
+
+void auto_rows(int* array, int n, int i_begin, int i_end)
+{
+    for (int i = i_begin; i < i_end; ++i)
+        sqrt_hash_row(array + static_cast<std::size_t>(i) * n, n, i, 0);
+}
+
+} // namespace
+
+void sqrt_hash_auto(int* array, int n)
+{
+    auto_rows(array, n, 0, n);
+}
+
+#ifdef SQRT_HASH_X86
+
+__attribute__((target("avx2"))) void sqrt_hash_auto_avx2(int* array, int n)
+{
+    for (int i = 0; i < n; ++i)
+        sqrt_hash_row(array + static_cast<std::size_t>(i) * n, n, i, 0);
+}
+
+namespace {
+
+__attribute__((target("avx2"))) inline __m256i hash32_avx2(__m256i h)
+{
+    h = _mm256_xor_si256(h, _mm256_srli_epi32(h, 16));
+    h = _mm256_mullo_epi32(h, _mm256_set1_epi32(static_cast<int>(0x85ebca6bu)));
+    h = _mm256_xor_si256(h, _mm256_srli_epi32(h, 13));
+    h = _mm256_mullo_epi32(h, _mm256_set1_epi32(static_cast<int>(0xc2b2ae35u)));
+    h = _mm256_xor_si256(h, _mm256_srli_epi32(h, 16));
+    return h;
+}
+
+// 8 ints of the array += sqrt of 8 hashes
+__attribute__((target("avx2"))) inline __m256i add_sqrt_avx2(__m256i a, __m256i h)
+{
+    const __m256 root = _mm256_sqrt_ps(_mm256_cvtepi32_ps(h));
+    return _mm256_cvttps_epi32(_mm256_add_ps(_mm256_cvtepi32_ps(a), root));
+}
+
+__attribute__((target("avx512f"))) inline __m512i hash32_avx512(__m512i h)
+{
+    h = _mm512_xor_si512(h, _mm512_srli_epi32(h, 16));
+    h = _mm512_mullo_epi32(h, _mm512_set1_epi32(static_cast<int>(0x85ebca6bu)));
+    h = _mm512_xor_si512(h, _mm512_srli_epi32(h, 13));
+    h = _mm512_mullo_epi32(h, _mm512_set1_epi32(static_cast<int>(0xc2b2ae35u)));
+    h = _mm512_xor_si512(h, _mm512_srli_epi32(h, 16));
+    return h;
+}
+
+// 16 ints of the array += sqrt of 16 hashes
+__attribute__((target("avx512f"))) inline __m512i add_sqrt_avx512(__m512i a, __m512i h)
+{
+    const __m512 root = _mm512_sqrt_ps(_mm512_cvtepi32_ps(h));
+    return _mm512_cvttps_epi32(_mm512_add_ps(_mm512_cvtepi32_ps(a), root));
+}
+
+} // namespace
+
+namespace {
+
+__attribute__((target("avx2"))) void avx2_rows(int* array, int n, int i_begin, int i_end)
+{
+    // lane k of the row handles column j + k, whose index is (j + k)*n + i
+    const __m256i lane_offsets =
+        _mm256_mullo_epi32(_mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7), _mm256_set1_epi32(n));
+    const __m256i step = _mm256_set1_epi32(8 * n);
+
+    for (int i = i_begin; i < i_end; ++i)
+    {
+        int* row = array + static_cast<std::size_t>(i) * n;
+        __m256i index = _mm256_add_epi32(_mm256_set1_epi32(i), lane_offsets);
+        int j = 0;
+        for (; j + 8 <= n; j += 8)
+        {
+            const __m256i h = _mm256_srli_epi32(hash32_avx2(index), 8);
+            const __m256i a = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(row + j));
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(row + j), add_sqrt_avx2(a, h));
+            index = _mm256_add_epi32(index, step);
+        }
+        sqrt_hash_row(row, n, i, j);
+    }
+}
+
+__attribute__((target("avx512f"))) void avx512_rows(int* array, int n, int i_begin, int i_end)
+{
+    const __m512i lane_offsets = _mm512_mullo_epi32(
+        _mm512_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15), _mm512_set1_epi32(n));
+    const __m512i step = _mm512_set1_epi32(16 * n);
+
+    for (int i = i_begin; i < i_end; ++i)
+    {
+        int* row = array + static_cast<std::size_t>(i) * n;
+        __m512i index = _mm512_add_epi32(_mm512_set1_epi32(i), lane_offsets);
+        int j = 0;
+        for (; j + 16 <= n; j += 16)
+        {
+            const __m512i h = _mm512_srli_epi32(hash32_avx512(index), 8);
+            const __m512i a = _mm512_loadu_si512(row + j);
+            _mm512_storeu_si512(row + j, add_sqrt_avx512(a, h));
+            index = _mm512_add_epi32(index, step);
+        }
+        sqrt_hash_row(row, n, i, j);
+    }
+}
+
+} // namespace
+
+void sqrt_hash_avx2(int* array, int n)
+{
+    avx2_rows(array, n, 0, n);
+}
+
+void sqrt_hash_avx512(int* array, int n)
+{
+    avx512_rows(array, n, 0, n);
+}
+
+#else
+
+// Not an x86 build: everything falls back to the portable loop.
+namespace {
+void avx2_rows(int* array, int n, int i_begin, int i_end) { auto_rows(array, n, i_begin, i_end); }
+void avx512_rows(int* array, int n, int i_begin, int i_end) { auto_rows(array, n, i_begin, i_end); }
+} // namespace
+
+void sqrt_hash_auto_avx2(int* array, int n) { sqrt_hash_auto(array, n); }
+void sqrt_hash_avx2(int* array, int n) { sqrt_hash_auto(array, n); }
+void sqrt_hash_avx512(int* array, int n) { sqrt_hash_auto(array, n); }
+
+#endif
+
+sqrt_hash_kernel select_sqrt_hash(simd_level level)
+{
+    switch (level)
+    {
+    case simd_level::avx512: return sqrt_hash_avx512;
+    case simd_level::avx2: return sqrt_hash_avx2;
+    default: return sqrt_hash_auto;
+    }
+}
+
+namespace {
+
+rows_kernel select_rows(simd_level level)
+{
+    switch (level)
+    {
+    case simd_level::avx512: return avx512_rows;
+    case simd_level::avx2: return avx2_rows;
+    default: return auto_rows;
+    }
+}
+
+} // namespace
+
+void sqrt_hash(int* array, int n)
+{
+    sqrt_hash_rows(array, n, 0, n);
+}
+
+void sqrt_hash_rows(int* array, int n, int row_begin, int row_end)
+{
+    static const rows_kernel kernel = select_rows(detect_simd_level());
+    kernel(array, n, row_begin, row_end);
+}
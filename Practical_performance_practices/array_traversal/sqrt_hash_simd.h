@@ -0,0 +1,71 @@
+#pragma once
+
+// Vectorized versions of the row major "+ some work" loop of
+// array_traversal_1.png:
+//
+//   array[i][j] += std::sqrt(std::hash<int>()(j*n + i));
+//
+// Two things keep the original from running many lanes wide:
+// std::hash<int> returns a size_t (libstdc++ simply returns the value),
+// and x86 has no packed unsigned 64 bit -> floating point conversion
+// before AVX-512DQ; and a double sqrt only fills half as many lanes as
+// a float one. So the vectorized kernels use a 32 bit integer hash
+// (the murmur3 finalizer: shifts, xors and 32 bit multiplies, all of
+// which exist as packed instructions), keep its top 24 bits (exactly
+// representable in a float) and take the square root in single
+// precision. IEEE sqrt is correctly rounded in scalar and packed form
+// alike, so every variant below produces bit for bit the same grid as
+// sqrt_hash_reference (as long as the grid values stay below 2^24).
+//
+// The kernel is picked at runtime: AVX-512 (16 lanes), AVX2 (8 lanes)
+// or the portable loop, which the compiler auto-vectorizes for whatever
+// the build targets.
+
+#include <cstdint>
+
+// murmur3 fmix32
+inline std::uint32_t hash32(std::uint32_t h)
+{
+    h ^= h >> 16;
+    h *= 0x85ebca6bu;
+    h ^= h >> 13;
+    h *= 0xc2b2ae35u;
+    h ^= h >> 16;
+    return h;
+}
+
+enum class simd_level
+{
+    portable,
+    avx2,
+    avx512
+};
+
+const char* to_string(simd_level level);
+
+// Best level this CPU (and OS) supports.
+simd_level detect_simd_level();
+
+// All of these compute, for an n x n row major grid,
+//   array[i*n + j] += sqrt(float(hash32(j*n + i) >> 8))
+// and give identical results.
+using sqrt_hash_kernel = void (*)(int* array, int n);
+
+// Portable loop, kept scalar on purpose (vectorization disabled).
+void sqrt_hash_reference(int* array, int n);
+// Same loop, left to the auto-vectorizer (baseline instruction set).
+void sqrt_hash_auto(int* array, int n);
+// Same loop, auto-vectorized with AVX2 enabled for this function only.
+void sqrt_hash_auto_avx2(int* array, int n);
+// Hand written intrinsics; only call them if the CPU supports them.
+void sqrt_hash_avx2(int* array, int n);
+void sqrt_hash_avx512(int* array, int n);
+
+// The hand written kernel for `level`.
+sqrt_hash_kernel select_sqrt_hash(simd_level level);
+
+// Runtime dispatch: the best kernel for this machine.
+void sqrt_hash(int* array, int n);
+// Same, only rows [row_begin, row_end) of the n x n grid, so that
+// several threads can share one grid.
+void sqrt_hash_rows(int* array, int n, int row_begin, int row_end);
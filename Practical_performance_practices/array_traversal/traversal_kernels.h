@@ -0,0 +1,38 @@
+#pragma once
+
+// The loops from array_traversal.png and array_traversal_1.png.
+// int array[n][n]; with n only known at runtime,
+// so it is a flat vector indexed as array[i * n + j].
+
+#include <cmath>
+#include <functional>
+#include <vector>
+
+inline void row_major(std::vector<int>& array, int n)
+{
+    for (int i = 0; i < n; ++i)
+        for (int j = 0; j < n; ++j)
+            array[i * n + j] += j;
+}
+
+inline void column_major(std::vector<int>& array, int n)
+{
+    for (int i = 0; i < n; ++i)
+        for (int j = 0; j < n; ++j)
+            array[j * n + i] += j;
+}
+
+// "+ some work"
+inline void row_major_work(std::vector<int>& array, int n)
+{
+    for (int i = 0; i < n; ++i)
+        for (int j = 0; j < n; ++j)
+            array[i * n + j] += std::sqrt(std::hash<int>()(j * n + i));
+}
+
+inline void column_major_work(std::vector<int>& array, int n)
+{
+    for (int i = 0; i < n; ++i)
+        for (int j = 0; j < n; ++j)
+            array[j * n + i] += std::sqrt(std::hash<int>()(i * n + j));
+}
@@ -0,0 +1,54 @@
+// CODE_SIZE_INSTANTIATIONS instantiations of one version of D<T>
+// (CODE_SIZE_PROBLEM, CODE_SIZE_SOLUTION or CODE_SIZE_DRY_LAYER), each
+// constructed once and called through the base. CMake builds this for
+// several counts and code_size_report.cmake compares the binaries.
+
+#include "dry_layer.h"
+#include "problem_solution.h"
+
+#include <memory>
+#include <utility>
+#include <vector>
+
+template <int N>
+struct tag
+{
+};
+
+#if defined(CODE_SIZE_PROBLEM)
+using base = problem::B;
+template <typename T>
+using derived = problem::D<T>;
+#elif defined(CODE_SIZE_SOLUTION)
+using base = solution::B;
+template <typename T>
+using derived = solution::D<T>;
+#else
+using base = vector_holder;
+template <typename T>
+using derived = thin<T>;
+#endif
+
+// One factory function per instantiation (a single function
+// constructing them all would be one huge function for the optimizer),
+// plain new to keep make_unique from being instantiated for every type.
+template <int... N>
+std::vector<std::unique_ptr<base>> make_all(std::integer_sequence<int, N...>)
+{
+    using factory = base* (*)(std::vector<int>);
+    const factory factories[] = {[](std::vector<int> v) -> base* { return new derived<tag<N>>(std::move(v)); }...};
+
+    std::vector<std::unique_ptr<base>> objects;
+    for (factory f : factories)
+        objects.emplace_back(f(std::vector<int>(4, static_cast<int>(objects.size()))));
+    return objects;
+}
+
+int main()
+{
+    long long sum = 0;
+    for (const auto& object : make_all(std::make_integer_sequence<int, CODE_SIZE_INSTANTIATIONS>()))
+        for (int v : object->get_vec())
+            sum += v;
+    return static_cast<int>(sum & 1);
+}
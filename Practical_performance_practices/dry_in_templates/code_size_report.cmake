@@ -0,0 +1,91 @@
+# Prints (and writes to OUTPUT) how the code of the code_size_instances
+# binaries grows with the number of D<T> instantiations:
+#
+#   cmake -DNM=nm -DSIZE=size -DOUTPUT=report.txt
+#         "-DBINARIES=problem@1@/path|problem@256@/path|..." -P code_size_report.cmake
+#
+# Per binary: the size of .text (size -A) and the code that nm
+# attributes to the instantiated classes themselves (the symbols
+# matching D<tag< or thin<tag<, their code only, not vtables or
+# typeinfo). Per variant: the bytes every additional instantiation
+# adds, between the smallest and the largest count.
+
+cmake_policy(VERSION 3.16)
+
+string(REPLACE "|" ";" binaries "${BINARIES}")
+
+set(report "dry_in_templates code size per D<T> instantiation\n")
+string(APPEND report "  variant       instantiations   .text bytes   D<T> code bytes   D<T> symbols\n")
+
+set(variants "")
+foreach(entry ${binaries})
+  string(REPLACE "@" ";" parts "${entry}")
+  list(GET parts 0 variant)
+  list(GET parts 1 count)
+  list(GET parts 2 binary)
+
+  execute_process(COMMAND "${SIZE}" -A "${binary}" OUTPUT_VARIABLE size_output RESULT_VARIABLE failed)
+  if(failed OR NOT size_output MATCHES "\n\\.text +([0-9]+)")
+    message(FATAL_ERROR "${SIZE} -A ${binary} failed")
+  endif()
+  set(text ${CMAKE_MATCH_1})
+
+  execute_process(COMMAND "${NM}" -C -S "${binary}" OUTPUT_VARIABLE nm_output RESULT_VARIABLE failed)
+  if(failed)
+    message(FATAL_ERROR "${NM} -C -S ${binary} failed")
+  endif()
+  string(REPLACE ";" "," nm_output "${nm_output}")
+  string(REPLACE "\n" ";" nm_lines "${nm_output}")
+  set(code 0)
+  set(symbols 0)
+  set(seen "")
+  foreach(line ${nm_lines})
+    # address size type name; aliases (the same address twice) count once
+    if(line MATCHES "^([0-9a-f]+) ([0-9a-f]+) [tTwW] .*(D<tag<|thin<tag<)")
+      set(address ${CMAKE_MATCH_1})
+      list(FIND seen ${address} known)
+      if(known EQUAL -1)
+        list(APPEND seen ${address})
+        math(EXPR code "${code} + 0x${CMAKE_MATCH_2}")
+        math(EXPR symbols "${symbols} + 1")
+      endif()
+    endif()
+  endforeach()
+
+  string(APPEND report "  ")
+  foreach(column "${variant}:14" "${count}:17" "${text}:14" "${code}:18" "${symbols}:0")
+    string(REGEX MATCH "^(.*):([0-9]+)$" ignored "${column}")
+    set(value "${CMAKE_MATCH_1}")
+    string(LENGTH "${value}" value_length)
+    math(EXPR padding "${CMAKE_MATCH_2} - ${value_length}")
+    string(APPEND report "${value}")
+    if(padding GREATER 0)
+      string(REPEAT " " ${padding} spaces)
+      string(APPEND report "${spaces}")
+    endif()
+  endforeach()
+  string(APPEND report "\n")
+
+  if(NOT variant IN_LIST variants)
+    list(APPEND variants ${variant})
+    set(first_${variant} ${count} ${text} ${code})
+  endif()
+  set(last_${variant} ${count} ${text} ${code})
+endforeach()
+
+foreach(variant ${variants})
+  list(GET first_${variant} 0 count0)
+  list(GET first_${variant} 1 text0)
+  list(GET first_${variant} 2 code0)
+  list(GET last_${variant} 0 count1)
+  list(GET last_${variant} 1 text1)
+  list(GET last_${variant} 2 code1)
+  if(count1 GREATER count0)
+    math(EXPR text_each "(${text1} - ${text0}) / (${count1} - ${count0})")
+    math(EXPR code_each "(${code1} - ${code0}) / (${count1} - ${count0})")
+    string(APPEND report "  ${variant}: +${text_each} bytes of .text per instantiation, ${code_each} of them in D<T>\n")
+  endif()
+endforeach()
+
+message("${report}")
+file(WRITE "${OUTPUT}" "${report}")
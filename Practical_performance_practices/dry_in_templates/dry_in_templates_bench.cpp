@@ -0,0 +1,150 @@
+// Benchmark for "Smaller Code Is Faster Code - DRY In Templates":
+//
+// problem.png   get_vec() and m_v live in the template D<T>, so every
+//               instantiation gets its own copy of the same code.
+// Solution.png  get_vec() and m_v moved up into the non-template B,
+//               there is exactly one get_vec() however many D<T> exist.
+//
+// Calling get_vec() through B& on a mix of many D<T> walks many
+// identical copies of the function in the problem version (more
+// instruction cache and branch target buffer entries) and one in
+// the solution version, as with dry_layer.h's thin<T>. (GCC's identical
+// code folding, -fipa-icf, may quietly merge some of the copies again;
+// the point of the slide is not to depend on that. The
+// dry_code_size_report target shows the bytes per instantiation.)
+//
+// All of these return the vector by value, so each call also allocates
+// and copies 8 ints. by_reference and span_view (problem_solution.h)
+// and dry_layer's vec() hand out the elements instead. The second group
+// calls get_vec() once per element read, as a loop condition or index
+// expression easily does; there the copies multiply.
+
+#include "bench.h"
+#include "dry_layer.h"
+#include "problem_solution.h"
+
+#include <cstdio>
+#include <memory>
+#include <utility>
+#include <vector>
+
+// Distinct types to instantiate D<T> with.
+template <int N>
+struct tag
+{
+};
+
+constexpr int instantiations = 64;
+
+template <typename Base, template <typename> class D, int... N>
+std::vector<std::unique_ptr<Base>> make_objects(std::size_t count, std::integer_sequence<int, N...>)
+{
+    using factory = std::unique_ptr<Base> (*)(std::vector<int>);
+    const factory factories[] = {
+        [](std::vector<int> v) -> std::unique_ptr<Base> {
+            return std::make_unique<D<tag<N>>>(std::move(v));
+        }...};
+
+    std::vector<std::unique_ptr<Base>> objects;
+    objects.reserve(count);
+    for (std::size_t k = 0; k < count; ++k)
+        objects.push_back(factories[k % sizeof...(N)](std::vector<int>(8, static_cast<int>(k))));
+    return objects;
+}
+
+template <typename Base>
+long long sum_vecs(const std::vector<std::unique_ptr<Base>>& objects)
+{
+    long long sum = 0;
+    for (const auto& object : objects)
+        for (int v : object->get_vec())
+            sum += v;
+    return sum;
+}
+
+template <typename Base>
+long long sum_vecs_per_element(const std::vector<std::unique_ptr<Base>>& objects)
+{
+    long long sum = 0;
+    for (const auto& object : objects)
+        for (std::size_t i = 0; i < object->get_vec().size(); ++i)
+            sum += object->get_vec()[i];
+    return sum;
+}
+
+long long sum_views(const std::vector<std::unique_ptr<vector_holder>>& objects)
+{
+    long long sum = 0;
+    for (const auto& object : objects)
+        for (int v : object->vec())
+            sum += v;
+    return sum;
+}
+
+long long sum_views_per_element(const std::vector<std::unique_ptr<vector_holder>>& objects)
+{
+    long long sum = 0;
+    for (const auto& object : objects)
+        for (std::size_t i = 0; i < object->vec().size(); ++i)
+            sum += object->vec()[i];
+    return sum;
+}
+
+int main(int argc, char** argv)
+{
+    bench::runner r("dry_in_templates", argc, argv);
+
+    const std::size_t count = r.size<std::size_t>(1 << 16, 1 << 8);
+    const auto seq = std::make_integer_sequence<int, instantiations>{};
+    const auto problem_objects = make_objects<problem::B, problem::D>(count, seq);
+    const auto solution_objects = make_objects<solution::B, solution::D>(count, seq);
+    const auto dry_layer_objects = make_objects<vector_holder, thin>(count, seq);
+    const auto by_reference_objects = make_objects<by_reference::B, by_reference::D>(count, seq);
+    const auto span_view_objects = make_objects<span_view::B, span_view::D>(count, seq);
+
+    // Every accessor, both loop shapes, checked before anything is measured.
+    const long long expected = sum_vecs(problem_objects);
+    const long long sums[] = {
+        sum_vecs_per_element(problem_objects),
+        sum_vecs(solution_objects),
+        sum_vecs_per_element(solution_objects),
+        sum_vecs(dry_layer_objects),
+        sum_vecs_per_element(dry_layer_objects),
+        sum_vecs(by_reference_objects),
+        sum_vecs_per_element(by_reference_objects),
+        sum_vecs(span_view_objects),
+        sum_vecs_per_element(span_view_objects),
+        sum_views(dry_layer_objects),
+        sum_views_per_element(dry_layer_objects),
+    };
+    for (long long sum : sums)
+        if (sum != expected)
+        {
+            std::fprintf(stderr, "the accessors disagree\n");
+            return 1;
+        }
+
+    r.run("get_vec_64_instantiations", "problem", count,
+          [&] { bench::do_not_optimize(sum_vecs(problem_objects)); });
+    r.run("get_vec_64_instantiations", "solution", count,
+          [&] { bench::do_not_optimize(sum_vecs(solution_objects)); });
+    r.run("get_vec_64_instantiations", "dry_layer", count,
+          [&] { bench::do_not_optimize(sum_vecs(dry_layer_objects)); });
+    r.run("get_vec_64_instantiations", "by_reference", count,
+          [&] { bench::do_not_optimize(sum_vecs(by_reference_objects)); });
+    r.run("get_vec_64_instantiations", "span_view", count,
+          [&] { bench::do_not_optimize(sum_vecs(span_view_objects)); });
+    r.run("get_vec_64_instantiations", "dry_layer_vec", count,
+          [&] { bench::do_not_optimize(sum_views(dry_layer_objects)); });
+
+    r.run("get_vec_per_element", "solution", count,
+          [&] { bench::do_not_optimize(sum_vecs_per_element(solution_objects)); });
+    r.run("get_vec_per_element", "by_reference", count,
+          [&] { bench::do_not_optimize(sum_vecs_per_element(by_reference_objects)); });
+    r.run("get_vec_per_element", "span_view", count,
+          [&] { bench::do_not_optimize(sum_vecs_per_element(span_view_objects)); });
+    r.run("get_vec_per_element", "dry_layer_vec", count,
+          [&] { bench::do_not_optimize(sum_views_per_element(dry_layer_objects)); });
+
+    return r.finish();
+}
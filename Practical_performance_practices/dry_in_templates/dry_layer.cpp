@@ -0,0 +1,22 @@
+#include "dry_layer.h"
+
+#include <utility>
+
+vector_holder::vector_holder(const std::vector<int>& v) : m_v(v) {}
+
+vector_holder::vector_holder(std::vector<int>&& v) : m_v(std::move(v)) {}
+
+vector_holder::~vector_holder() = default;
+
+vector_holder::vector_holder(const vector_holder& other) = default;
+
+vector_holder& vector_holder::operator=(const vector_holder& other) = default;
+
+vector_holder::vector_holder(vector_holder&& other) noexcept = default;
+
+vector_holder& vector_holder::operator=(vector_holder&& other) noexcept = default;
+
+std::vector<int> vector_holder::get_vec() const
+{
+    return m_v;
+}
@@ -0,0 +1,57 @@
+#pragma once
+
+// "Move everything out of the template that you can", as a layer to
+// derive from instead of a rewrite per class:
+//
+//   template <typename T>
+//   using D = thin<T, vector_holder>;   // or derive from it
+//
+// vector_holder is the non-template half: the vector and everything done
+// with it, declared here and defined once, in dry_layer.cpp. Not even
+// inline: an inline member of a non-template class is emitted once per
+// binary anyway, but it is also inlined into every D<T> member that
+// calls it, which is the copy per instantiation all over again.
+// Copying, moving and destroying the vector are out of line for the same
+// reason, since D<T>'s implicit special members call them (its deleting
+// destructor is a vtable entry, so it exists for every T).
+//
+// thin<T, Base> is the template half and holds only what really depends
+// on T; here that is type_size(). Per instantiation that leaves a
+// vtable, the tiny destructors and the T dependent functions, which is
+// what code_size_report measures against problem.png and Solution.png.
+
+#include <cstddef>
+#include <span>
+#include <vector>
+
+class vector_holder
+{
+  public:
+    // Not by value: the caller would construct and destroy the
+    // parameter, and the callers are D<T>'s constructors.
+    explicit vector_holder(const std::vector<int>& v);
+    explicit vector_holder(std::vector<int>&& v);
+    virtual ~vector_holder();
+    vector_holder(const vector_holder& other);
+    vector_holder& operator=(const vector_holder& other);
+    vector_holder(vector_holder&& other) noexcept;
+    vector_holder& operator=(vector_holder&& other) noexcept;
+
+    std::vector<int> get_vec() const;
+    // The elements without copying them; neither virtual nor out of
+    // line, since the call would be bigger than the two loads it makes.
+    std::span<const int> vec() const noexcept { return m_v; }
+
+    // What thin<T> fills in.
+    virtual std::size_t type_size() const = 0;
+
+  protected:
+    std::vector<int> m_v;
+};
+
+template <typename T, typename Base = vector_holder>
+struct thin : Base
+{
+    using Base::Base;
+    std::size_t type_size() const override { return sizeof(T); }
+};
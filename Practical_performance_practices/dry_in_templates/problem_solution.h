@@ -0,0 +1,114 @@
+#pragma once
+
+// The two versions of problem.png and Solution.png, shared by
+// dry_in_templates_bench.cpp and code_size_instances.cpp.
+//
+// problem   get_vec() and m_v live in the template D<T>, so every
+//           instantiation gets its own copy of the same code.
+// solution  get_vec() and m_v moved up into the non-template B, there
+//           is exactly one get_vec() however many D<T> exist.
+//
+// dry_layer.h is the same move made reusable.
+//
+// Both return the vector by value: every call through B allocates and
+// copies it, whether the caller keeps it or only reads it once. Two
+// accessors that do not copy, with m_v in B as in the solution:
+//
+// by_reference  const std::vector<int>& get_vec(): valid as long as the
+//               object is and m_v is not reassigned
+// span_view     std::span<const int> get_vec(): the same, but the caller
+//               no longer depends on the container (an array, a
+//               small_vector or a slice of a bigger buffer work as well)
+
+#include <span>
+#include <utility>
+#include <vector>
+
+namespace problem {
+
+struct B
+{
+    virtual ~B() = default;
+    B() = default;
+    B(const B&) = default;
+    B& operator=(const B&) = default;
+    B(B&&) = default;
+    B& operator=(B&&) = default;
+    virtual std::vector<int> get_vec() const = 0;
+};
+
+template <typename T>
+struct D : B
+{
+    explicit D(std::vector<int> v) : m_v(std::move(v)) {}
+    std::vector<int> get_vec() const override { return m_v; }
+    std::vector<int> m_v;
+};
+
+} // namespace problem
+
+namespace solution {
+
+struct B
+{
+    explicit B(std::vector<int> v) : m_v(std::move(v)) {}
+    virtual ~B() = default;
+    B(const B&) = default;
+    B& operator=(const B&) = default;
+    B(B&&) = default;
+    B& operator=(B&&) = default;
+    virtual std::vector<int> get_vec() const { return m_v; }
+    std::vector<int> m_v;
+};
+
+template <typename T>
+struct D : B
+{
+    using B::B;
+};
+
+} // namespace solution
+
+namespace by_reference {
+
+struct B
+{
+    explicit B(std::vector<int> v) : m_v(std::move(v)) {}
+    virtual ~B() = default;
+    B(const B&) = default;
+    B& operator=(const B&) = default;
+    B(B&&) = default;
+    B& operator=(B&&) = default;
+    virtual const std::vector<int>& get_vec() const { return m_v; }
+    std::vector<int> m_v;
+};
+
+template <typename T>
+struct D : B
+{
+    using B::B;
+};
+
+} // namespace by_reference
+
+namespace span_view {
+
+struct B
+{
+    explicit B(std::vector<int> v) : m_v(std::move(v)) {}
+    virtual ~B() = default;
+    B(const B&) = default;
+    B& operator=(const B&) = default;
+    B(B&&) = default;
+    B& operator=(B&&) = default;
+    virtual std::span<const int> get_vec() const { return m_v; }
+    std::vector<int> m_v;
+};
+
+template <typename T>
+struct D : B
+{
+    using B::B;
+};
+
+} // namespace span_view
@@ -0,0 +1,97 @@
+// Replacement global allocation functions that count, see alloc_counter.h.
+
+#include "alloc_counter.h"
+
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+namespace {
+
+std::atomic<std::size_t> g_allocations{0};
+std::atomic<std::size_t> g_deallocations{0};
+std::atomic<std::size_t> g_bytes{0};
+
+void* counted_allocate(std::size_t size, std::size_t align = 0) noexcept
+{
+    if (size == 0)
+        size = 1;
+    void* p;
+    if (align > alignof(std::max_align_t))
+        p = std::aligned_alloc(align, (size + align - 1) / align * align);
+    else
+        p = std::malloc(size);
+    if (p)
+    {
+        g_allocations.fetch_add(1, std::memory_order_relaxed);
+        g_bytes.fetch_add(size, std::memory_order_relaxed);
+    }
+    return p;
+}
+
+void* counted_allocate_or_throw(std::size_t size, std::size_t align = 0)
+{
+    for (;;)
+    {
+        if (void* p = counted_allocate(size, align))
+            return p;
+        const auto handler = std::get_new_handler();
+        if (!handler)
+            throw std::bad_alloc();
+        handler();
+    }
+}
+
+void counted_free(void* p) noexcept
+{
+    if (!p)
+        return;
+    g_deallocations.fetch_add(1, std::memory_order_relaxed);
+    std::free(p);
+}
+
+} // namespace
+
+namespace bench {
+
+alloc_counts alloc_totals()
+{
+    return {g_allocations.load(std::memory_order_relaxed), g_deallocations.load(std::memory_order_relaxed),
+            g_bytes.load(std::memory_order_relaxed)};
+}
+
+} // namespace bench
+
+void* operator new(std::size_t size) { return counted_allocate_or_throw(size); }
+void* operator new[](std::size_t size) { return counted_allocate_or_throw(size); }
+void* operator new(std::size_t size, std::align_val_t align)
+{
+    return counted_allocate_or_throw(size, static_cast<std::size_t>(align));
+}
+void* operator new[](std::size_t size, std::align_val_t align)
+{
+    return counted_allocate_or_throw(size, static_cast<std::size_t>(align));
+}
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept { return counted_allocate(size); }
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept { return counted_allocate(size); }
+void* operator new(std::size_t size, std::align_val_t align, const std::nothrow_t&) noexcept
+{
+    return counted_allocate(size, static_cast<std::size_t>(align));
+}
+void* operator new[](std::size_t size, std::align_val_t align, const std::nothrow_t&) noexcept
+{
+    return counted_allocate(size, static_cast<std::size_t>(align));
+}
+
+void operator delete(void* p) noexcept { counted_free(p); }
+void operator delete[](void* p) noexcept { counted_free(p); }
+void operator delete(void* p, std::size_t) noexcept { counted_free(p); }
+void operator delete[](void* p, std::size_t) noexcept { counted_free(p); }
+void operator delete(void* p, std::align_val_t) noexcept { counted_free(p); }
+void operator delete[](void* p, std::align_val_t) noexcept { counted_free(p); }
+void operator delete(void* p, std::size_t, std::align_val_t) noexcept { counted_free(p); }
+void operator delete[](void* p, std::size_t, std::align_val_t) noexcept { counted_free(p); }
+void operator delete(void* p, const std::nothrow_t&) noexcept { counted_free(p); }
+void operator delete[](void* p, const std::nothrow_t&) noexcept { counted_free(p); }
+void operator delete(void* p, std::align_val_t, const std::nothrow_t&) noexcept { counted_free(p); }
+void operator delete[](void* p, std::align_val_t, const std::nothrow_t&) noexcept { counted_free(p); }
@@ -0,0 +1,121 @@
+#pragma once
+
+// Counting allocations, copies and moves, so that claims like "this
+// costs exactly one allocation" or "this does not copy" can be checked
+// by a program instead of argued about (and an accidental copy later on
+// makes the check fail).
+//
+// Allocations: link the alloc_counter library. It replaces the global
+// operator new/delete (all of them: array, aligned, nothrow, sized) with
+// versions that count and then forward to malloc/aligned_alloc/free.
+//
+//   bench::alloc_scope scope;
+//   example e = create_example(5000);
+//   scope.allocations();   // 1
+//
+// Copies and moves: wrap a type in bench::counted<T>. It behaves like T
+// and counts its copy/move constructions and assignments, per T:
+//
+//   auto& counts = bench::counted<example>::counts();
+//   counts.reset();
+//   std::vector<bench::counted<example>> v;   ...
+//   counts.copies();   // 0 if example is nothrow movable
+//
+// The counters are process wide atomics (relaxed): other threads'
+// allocations show up too, so measure single threaded sections.
+
+#include <cstddef>
+#include <type_traits>
+#include <utility>
+
+namespace bench {
+
+struct alloc_counts
+{
+    std::size_t allocations = 0;
+    std::size_t deallocations = 0;
+    std::size_t bytes = 0;   // requested by the allocations
+};
+
+// Totals since the program started.
+alloc_counts alloc_totals();
+
+// Allocations made since the scope was created.
+class alloc_scope
+{
+  public:
+    alloc_scope() : m_start(alloc_totals()) {}
+
+    alloc_counts counts() const
+    {
+        const auto now = alloc_totals();
+        return {now.allocations - m_start.allocations, now.deallocations - m_start.deallocations,
+                now.bytes - m_start.bytes};
+    }
+
+    std::size_t allocations() const { return counts().allocations; }
+    std::size_t deallocations() const { return counts().deallocations; }
+    std::size_t bytes() const { return counts().bytes; }
+
+  private:
+    alloc_counts m_start;
+};
+
+struct lifecycle_counts
+{
+    std::size_t copy_constructions = 0;
+    std::size_t move_constructions = 0;
+    std::size_t copy_assignments = 0;
+    std::size_t move_assignments = 0;
+
+    std::size_t copies() const { return copy_constructions + copy_assignments; }
+    std::size_t moves() const { return move_constructions + move_assignments; }
+    void reset() { *this = {}; }
+};
+
+// T with its copy and move operations counted. Keeps T's noexcept
+// guarantees, so std::vector<counted<T>> relocates exactly like
+// std::vector<T> would. counted<T> always has move operations, so for a
+// T without them a move that T carries out as a copy is counted as a
+// move; count that T's allocations instead.
+template <typename T>
+class counted : public T
+{
+  public:
+    using T::T;
+
+    counted(const counted& other) noexcept(std::is_nothrow_copy_constructible_v<T>)
+        : T(static_cast<const T&>(other))
+    {
+        ++s_counts.copy_constructions;
+    }
+
+    counted(counted&& other) noexcept(std::is_nothrow_move_constructible_v<T>)
+        : T(static_cast<T&&>(other))
+    {
+        ++s_counts.move_constructions;
+    }
+
+    counted& operator=(const counted& other) noexcept(std::is_nothrow_copy_assignable_v<T>)
+    {
+        T::operator=(static_cast<const T&>(other));
+        ++s_counts.copy_assignments;
+        return *this;
+    }
+
+    counted& operator=(counted&& other) noexcept(std::is_nothrow_move_assignable_v<T>)
+    {
+        T::operator=(static_cast<T&&>(other));
+        ++s_counts.move_assignments;
+        return *this;
+    }
+
+    ~counted() = default;
+
+    static lifecycle_counts& counts() { return s_counts; }
+
+  private:
+    static inline lifecycle_counts s_counts;
+};
+
+} // namespace bench
@@ -0,0 +1,407 @@
+#pragma once
+
+// A tiny, dependency free benchmark harness shared by every
+// benchmark executable in this repository.
+//
+// Each case is run a few times without being measured (warm-up,
+// so caches, branch predictors and the allocator settle down) and
+// then a number of measured repetitions. From the repetitions we
+// report the median (robust against the odd context switch) and
+// the 99th percentile (how bad does it get). The first case that is
+// run inside a group is treated as the baseline ("before") and every
+// following case of the same group is reported relative to it
+// ("after"), which is exactly the before/after pairs from the notes.
+//
+// Command line (shared by all the benchmark executables):
+//   --reps N        measured repetitions per case (default 15)
+//   --warmup N      unmeasured repetitions per case (default 2)
+//   --filter TEXT   only run cases whose "group/name" contains TEXT
+//   --json PATH     also write the results as JSON to PATH
+//   --quick         shrink the problem sizes (smoke testing)
+//   --no-perf       do not open the hardware counters at all
+//   --KEY=VALUE     benchmark specific parameter, read with runner::param
+//
+// Where perf_event_open works, the measured repetitions of every case
+// are also counted (perf_counters.h) and a second line reports IPC,
+// L1D and LLC misses per item and the share of backend stalled cycles,
+// so a speedup comes with the reason for it. Counters the machine does
+// not expose are left out of the output. Threads started after the
+// runner are counted along with the main thread, so construct the
+// runner before any pool or worker a case runs on.
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "perf_counters.h"
+
+// Keeps a function out of line so its call (and whatever happens at
+// the call boundary) is really measured.
+#if defined(__GNUC__) || defined(__clang__)
+#define BENCH_NOINLINE __attribute__((noinline))
+#elif defined(_MSC_VER)
+#define BENCH_NOINLINE __declspec(noinline)
+#else
+#define BENCH_NOINLINE
+#endif
+
+// BENCH_NOINLINE, and on top of that the compiler may not specialize the
+// function for what its callers pass (GCC clones a function called with
+// one constant function pointer and inlines the pointee), as if it were
+// in another translation unit.
+#if defined(__GNUC__) && !defined(__clang__)
+#define BENCH_NOIPA __attribute__((noipa))
+#else
+#define BENCH_NOIPA BENCH_NOINLINE
+#endif
+
+namespace bench {
+
+// Keep the compiler from throwing away a value we computed
+// only for the sake of measuring how long it takes.
+template <typename T>
+inline void do_not_optimize(T const& value)
+{
+#if defined(__GNUC__) || defined(__clang__)
+    asm volatile("" : : "r,m"(value) : "memory");
+#else
+    static volatile char sink;
+    sink = *reinterpret_cast<const volatile char*>(&value);
+#endif
+}
+
+// Force pending stores to be considered observable.
+inline void clobber_memory()
+{
+#if defined(__GNUC__) || defined(__clang__)
+    asm volatile("" : : : "memory");
+#endif
+}
+
+struct stats
+{
+    double min = 0;
+    double median = 0;
+    double mean = 0;
+    double p99 = 0;
+    double max = 0;
+};
+
+// Nearest-rank percentile over an already sorted sample.
+inline double percentile(const std::vector<double>& sorted, double p)
+{
+    if (sorted.empty())
+        return 0;
+    const auto rank = static_cast<std::size_t>(std::ceil(p / 100.0 * sorted.size()));
+    return sorted[std::min(sorted.size() - 1, rank == 0 ? 0 : rank - 1)];
+}
+
+inline stats summarize(std::vector<double> samples)
+{
+    stats s;
+    if (samples.empty())
+        return s;
+    std::sort(samples.begin(), samples.end());
+    s.min = samples.front();
+    s.max = samples.back();
+    const auto n = samples.size();
+    s.median = n % 2 ? samples[n / 2] : (samples[n / 2 - 1] + samples[n / 2]) / 2;
+    double sum = 0;
+    for (auto v : samples)
+        sum += v;
+    s.mean = sum / n;
+    s.p99 = percentile(samples, 99);
+    return s;
+}
+
+struct result
+{
+    std::string group;
+    std::string name;
+    std::size_t items = 1;   // work items processed by one repetition
+    std::size_t reps = 0;
+    stats ns;                // nanoseconds per repetition
+    double speedup = 1;      // baseline median / this median
+    // per repetition, over all measured repetitions; only the entries
+    // with counter_available set were measured
+    std::array<double, counter_count> counters{};
+    std::array<bool, counter_count> counter_available{};
+
+    bool has(counter c) const { return counter_available[static_cast<std::size_t>(c)]; }
+    double get(counter c) const { return counters[static_cast<std::size_t>(c)]; }
+};
+
+struct options
+{
+    int reps = 15;
+    int warmup = 2;
+    bool quick = false;
+    bool perf = true;
+    std::string filter;
+    std::string json;
+    std::map<std::string, std::string> params;
+};
+
+inline options parse_options(int argc, char** argv)
+{
+    options opt;
+    for (int i = 1; i < argc; ++i)
+    {
+        const std::string arg = argv[i];
+        auto next = [&]() -> std::string {
+            if (i + 1 >= argc)
+            {
+                std::cerr << "missing value for " << arg << '\n';
+                std::exit(2);
+            }
+            return argv[++i];
+        };
+        if (arg == "--reps")
+            opt.reps = std::max(1, std::atoi(next().c_str()));
+        else if (arg == "--warmup")
+            opt.warmup = std::max(0, std::atoi(next().c_str()));
+        else if (arg == "--filter")
+            opt.filter = next();
+        else if (arg == "--json")
+            opt.json = next();
+        else if (arg == "--quick")
+            opt.quick = true;
+        else if (arg == "--no-perf")
+            opt.perf = false;
+        else if (arg == "--help" || arg == "-h")
+        {
+            std::cout << "usage: " << argv[0]
+                      << " [--reps N] [--warmup N] [--filter TEXT] [--json PATH] [--quick] [--no-perf]\n"
+                      << "       [--KEY=VALUE...]\n";
+            std::exit(0);
+        }
+        else if (arg.rfind("--", 0) == 0 && arg.find('=') != std::string::npos)
+        {
+            const auto eq = arg.find('=');
+            opt.params[arg.substr(2, eq - 2)] = arg.substr(eq + 1);
+        }
+        else
+        {
+            std::cerr << "unknown argument: " << arg << '\n';
+            std::exit(2);
+        }
+    }
+    return opt;
+}
+
+inline std::string json_escape(const std::string& s)
+{
+    std::string out;
+    for (char c : s)
+    {
+        switch (c)
+        {
+        case '"': out += "\\\""; break;
+        case '\\': out += "\\\\"; break;
+        case '\n': out += "\\n"; break;
+        default: out += c;
+        }
+    }
+    return out;
+}
+
+class runner
+{
+  public:
+    runner(std::string suite, int argc, char** argv)
+        : m_suite(std::move(suite)), m_opt(parse_options(argc, argv)), m_perf(m_opt.perf)
+    {
+        std::printf("%-56s %12s %12s %12s %10s\n",
+                    m_suite.c_str(), "median(ns)", "p99(ns)", "ns/item", "speedup");
+        if (m_opt.perf && !m_perf.any_hardware())
+            std::printf("  (hardware counters unavailable here, e.g. in a VM)\n");
+    }
+
+    const options& opts() const { return m_opt; }
+    bool quick() const { return m_opt.quick; }
+
+    // Pick the problem size: the full one normally, a small one
+    // under --quick so that a smoke run finishes in a blink.
+    template <typename T>
+    T size(T full, T quick) const { return m_opt.quick ? quick : full; }
+
+    // Value of --key=VALUE, or `fallback` when it was not given.
+    long param(const std::string& key, long fallback) const
+    {
+        const auto it = m_opt.params.find(key);
+        return it == m_opt.params.end() ? fallback : std::atol(it->second.c_str());
+    }
+
+    // Runs `body` (warm-up + measured repetitions). `items` is the
+    // number of elements/operations one call of `body` processes,
+    // used to report a per-item cost.
+    template <typename F>
+    void run(const std::string& group, const std::string& name,
+             std::size_t items, F&& body)
+    {
+        const std::string full = group + "/" + name;
+        if (!m_opt.filter.empty() && full.find(m_opt.filter) == std::string::npos)
+            return;
+
+        for (int i = 0; i < m_opt.warmup; ++i)
+            body();
+
+        std::vector<double> samples;
+        samples.reserve(m_opt.reps);
+        // the counters also see the clock reads, which is noise next to
+        // a repetition worth measuring
+        if (m_opt.perf)
+            m_perf.start();
+        for (int i = 0; i < m_opt.reps; ++i)
+        {
+            const auto start = std::chrono::steady_clock::now();
+            body();
+            clobber_memory();
+            const auto stop = std::chrono::steady_clock::now();
+            samples.push_back(std::chrono::duration<double, std::nano>(stop - start).count());
+        }
+        if (m_opt.perf)
+            m_perf.stop();
+
+        result r;
+        r.group = group;
+        r.name = name;
+        r.items = items == 0 ? 1 : items;
+        r.reps = samples.size();
+        r.ns = summarize(std::move(samples));
+        if (m_opt.perf)
+            for (std::size_t k = 0; k < counter_count; ++k)
+            {
+                r.counter_available[k] = m_perf.available(static_cast<counter>(k));
+                r.counters[k] = m_perf.value(static_cast<counter>(k)) / r.reps;
+            }
+
+        // the first case of a group is the baseline of that group
+        auto base = std::find_if(m_results.begin(), m_results.end(),
+                                 [&](const result& o) { return o.group == group; });
+        if (base != m_results.end() && r.ns.median > 0)
+            r.speedup = base->ns.median / r.ns.median;
+
+        std::printf("  %-54s %12.0f %12.0f %12.3f %9.2fx\n",
+                    full.c_str(), r.ns.median, r.ns.p99,
+                    r.ns.median / r.items, r.speedup);
+        if (m_perf.any_hardware())
+            print_counters(r);
+        std::fflush(stdout);
+
+        m_results.push_back(std::move(r));
+    }
+
+    const std::vector<result>& results() const { return m_results; }
+
+    // Writes the JSON report (if asked for) and returns the exit code for main.
+    int finish() const
+    {
+        if (m_opt.json.empty())
+            return 0;
+        std::ofstream out(m_opt.json);
+        if (!out)
+        {
+            std::cerr << "cannot write " << m_opt.json << '\n';
+            return 1;
+        }
+        write_json(out);
+        return 0;
+    }
+
+    void write_json(std::ostream& out) const
+    {
+        out << "{\n  \"suite\": \"" << json_escape(m_suite) << "\",\n"
+            << "  \"compiler\": \"" << json_escape(compiler()) << "\",\n"
+            << "  \"reps\": " << m_opt.reps << ",\n"
+            << "  \"warmup\": " << m_opt.warmup << ",\n"
+            << "  \"quick\": " << (m_opt.quick ? "true" : "false") << ",\n"
+            << "  \"params\": {";
+        for (auto it = m_opt.params.begin(); it != m_opt.params.end(); ++it)
+            out << (it == m_opt.params.begin() ? "" : ", ") << '"' << json_escape(it->first)
+                << "\": \"" << json_escape(it->second) << '"';
+        out << "},\n"
+            << "  \"results\": [";
+        for (std::size_t i = 0; i < m_results.size(); ++i)
+        {
+            const auto& r = m_results[i];
+            out << (i ? ",\n" : "\n")
+                << "    {\"group\": \"" << json_escape(r.group) << "\""
+                << ", \"name\": \"" << json_escape(r.name) << "\""
+                << ", \"items\": " << r.items
+                << ", \"reps\": " << r.reps
+                << ", \"min_ns\": " << r.ns.min
+                << ", \"median_ns\": " << r.ns.median
+                << ", \"mean_ns\": " << r.ns.mean
+                << ", \"p99_ns\": " << r.ns.p99
+                << ", \"max_ns\": " << r.ns.max
+                << ", \"median_ns_per_item\": " << r.ns.median / r.items
+                << ", \"speedup_vs_baseline\": " << r.speedup;
+            bool first = true;
+            for (std::size_t k = 0; k < counter_count; ++k)
+                if (r.counter_available[k])
+                {
+                    out << (first ? ", \"counters_per_rep\": {" : ", ") << '"'
+                        << to_string(static_cast<counter>(k)) << "\": " << r.counters[k];
+                    first = false;
+                }
+            out << (first ? "}" : "}}");
+        }
+        out << "\n  ]\n}\n";
+    }
+
+    static std::string compiler()
+    {
+#if defined(__clang__)
+        return std::string("clang ") + __clang_version__;
+#elif defined(__GNUC__)
+        return std::string("gcc ") + __VERSION__;
+#elif defined(_MSC_VER)
+        return "msvc " + std::to_string(_MSC_VER);
+#else
+        return "unknown";
+#endif
+    }
+
+  private:
+    // "    ipc 1.82  l1d-miss/item 0.063  ..." for whatever was counted
+    static void print_counters(const result& r)
+    {
+        std::string line;
+        char buf[64];
+        auto add = [&](const char* fmt, double value) {
+            std::snprintf(buf, sizeof(buf), fmt, value);
+            line += buf;
+        };
+        const double items = static_cast<double>(r.items);
+        if (r.has(counter::cycles) && r.has(counter::instructions) && r.get(counter::cycles) > 0)
+            add("  ipc %.2f", r.get(counter::instructions) / r.get(counter::cycles));
+        if (r.has(counter::l1d_misses))
+            add("  l1d-miss/item %.3f", r.get(counter::l1d_misses) / items);
+        if (r.has(counter::llc_misses))
+            add("  llc-miss/item %.4f", r.get(counter::llc_misses) / items);
+        if (r.has(counter::cycles) && r.has(counter::stalled_cycles_backend) && r.get(counter::cycles) > 0)
+            add("  backend-stall %.0f%%", 100 * r.get(counter::stalled_cycles_backend) / r.get(counter::cycles));
+        if (r.has(counter::page_faults))
+            add("  faults/rep %.0f", r.get(counter::page_faults));
+        if (!line.empty())
+            std::printf("  %s\n", line.c_str());
+    }
+
+    std::string m_suite;
+    options m_opt;
+    std::vector<result> m_results;
+    perf_counters m_perf;
+};
+
+} // namespace bench
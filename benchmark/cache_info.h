@@ -0,0 +1,137 @@
+#pragma once
+
+// Detects the data cache sizes of the machine the benchmark runs on.
+//
+// On Linux every cache of cpu0 is described under
+//   /sys/devices/system/cpu/cpu0/cache/index*/{level,type,size,coherency_line_size}
+// (size is written like "48K" or "105M"). Instruction caches are
+// skipped. When sysfs is not available (other OS, containers that
+// hide it) we fall back to sysconf and then to typical values, and
+// say so in `source`.
+
+#include <algorithm>
+#include <cstddef>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#if defined(__unix__)
+#include <unistd.h>
+#endif
+
+namespace bench {
+
+struct cache_level
+{
+    int level = 0;
+    std::size_t size = 0;        // bytes
+    std::size_t line_size = 64;  // bytes
+};
+
+struct cache_info
+{
+    std::vector<cache_level> levels;  // data/unified caches, L1 first
+    std::string source;               // "sysfs", "sysconf" or "default"
+
+    std::size_t line_size() const { return levels.empty() ? 64 : levels.front().line_size; }
+
+    // Size of the given level, or 0 when the machine does not have it.
+    std::size_t size(int level) const
+    {
+        for (const auto& l : levels)
+            if (l.level == level)
+                return l.size;
+        return 0;
+    }
+
+    std::size_t last_level_size() const { return levels.empty() ? 0 : levels.back().size; }
+
+    // Name of the smallest cache a working set of `bytes` fits in.
+    std::string fits_in(std::size_t bytes) const
+    {
+        for (const auto& l : levels)
+            if (bytes <= l.size)
+                return std::string("L").append(std::to_string(l.level));
+        return "DRAM";
+    }
+};
+
+// "48K" -> 49152, "2048K" -> 2097152, "105M" -> 110100480
+inline std::size_t parse_cache_size(const std::string& text)
+{
+    std::size_t value = 0;
+    std::size_t pos = 0;
+    while (pos < text.size() && text[pos] >= '0' && text[pos] <= '9')
+        value = value * 10 + static_cast<std::size_t>(text[pos++] - '0');
+    if (pos < text.size())
+    {
+        switch (text[pos])
+        {
+        case 'K': case 'k': value <<= 10; break;
+        case 'M': case 'm': value <<= 20; break;
+        case 'G': case 'g': value <<= 30; break;
+        default: break;
+        }
+    }
+    return value;
+}
+
+namespace detail {
+
+inline bool read_line(const std::string& path, std::string& out)
+{
+    std::ifstream in(path);
+    return static_cast<bool>(std::getline(in, out));
+}
+
+} // namespace detail
+
+inline cache_info detect_caches()
+{
+    cache_info info;
+
+    for (int index = 0;; ++index)
+    {
+        const std::string dir = "/sys/devices/system/cpu/cpu0/cache/index" + std::to_string(index) + "/";
+        std::string level, type, size, line;
+        if (!detail::read_line(dir + "level", level) || !detail::read_line(dir + "size", size))
+            break;
+        detail::read_line(dir + "type", type);
+        if (type == "Instruction")
+            continue;
+        cache_level l;
+        l.level = std::stoi(level);
+        l.size = parse_cache_size(size);
+        if (detail::read_line(dir + "coherency_line_size", line))
+            l.line_size = parse_cache_size(line);
+        info.levels.push_back(l);
+    }
+    if (!info.levels.empty())
+    {
+        std::sort(info.levels.begin(), info.levels.end(),
+                  [](const cache_level& a, const cache_level& b) { return a.level < b.level; });
+        info.source = "sysfs";
+        return info;
+    }
+
+#if defined(_SC_LEVEL1_DCACHE_SIZE)
+    const long sizes[] = {sysconf(_SC_LEVEL1_DCACHE_SIZE), sysconf(_SC_LEVEL2_CACHE_SIZE),
+                          sysconf(_SC_LEVEL3_CACHE_SIZE)};
+    const long line = sysconf(_SC_LEVEL1_DCACHE_LINESIZE);
+    for (int i = 0; i < 3; ++i)
+        if (sizes[i] > 0)
+            info.levels.push_back({i + 1, static_cast<std::size_t>(sizes[i]),
+                                   line > 0 ? static_cast<std::size_t>(line) : 64});
+    if (!info.levels.empty())
+    {
+        info.source = "sysconf";
+        return info;
+    }
+#endif
+
+    info.levels = {{1, 32u << 10, 64}, {2, 1u << 20, 64}, {3, 8u << 20, 64}};
+    info.source = "default";
+    return info;
+}
+
+} // namespace bench
@@ -0,0 +1,215 @@
+#pragma once
+
+// Hardware performance counters around a benchmark region, on Linux via
+// perf_event_open(2).
+//
+// array_traversal_1.mdt: "profilers generally do not show we are waiting
+// for data". The counters do: a loop that retires few instructions per
+// cycle while missing L1/LLC a lot is waiting for memory, one with a
+// high IPC and few misses is bound by computation. So every speedup
+// claim gets IPC and miss rates next to the time.
+//
+//   bench::perf_counters counters;          // opens the events once
+//   {
+//       bench::perf_scope scope(counters);  // counts while alive
+//       kernel();
+//   }
+//   counters.value(bench::counter::llc_misses);
+//
+// Only user space is counted (exclude_kernel), which works with the
+// default perf_event_paranoid of 2: that of the thread that opened the
+// counters and of every thread it starts afterwards (inherit), so a case
+// that runs on a pool or on threads of its own is counted where the work
+// happens, not in the main thread waiting for it. Threads started before
+// the counters were opened are not seen; open them (construct the
+// bench::runner) first. Events the CPU or the
+// hypervisor does not expose (many VMs expose none) are simply reported
+// as unavailable; everything else keeps working. Each event is opened on
+// its own so that one unsupported event does not take the others down,
+// and values are scaled by time_enabled / time_running in case the kernel
+// had to multiplex them.
+
+#include <array>
+#include <cstdint>
+#include <cstring>
+
+#if defined(__linux__)
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace bench {
+
+enum class counter
+{
+    cycles,
+    instructions,
+    stalled_cycles_backend,
+    l1d_misses,
+    llc_misses,
+    page_faults,
+    count_
+};
+
+constexpr std::size_t counter_count = static_cast<std::size_t>(counter::count_);
+
+inline const char* to_string(counter c)
+{
+    switch (c)
+    {
+    case counter::cycles: return "cycles";
+    case counter::instructions: return "instructions";
+    case counter::stalled_cycles_backend: return "stalled_cycles_backend";
+    case counter::l1d_misses: return "l1d_misses";
+    case counter::llc_misses: return "llc_misses";
+    case counter::page_faults: return "page_faults";
+    default: return "?";
+    }
+}
+
+class perf_counters
+{
+  public:
+    // With enabled false nothing is opened (--no-perf) and every counter
+    // reports unavailable.
+    explicit perf_counters(bool enabled = true)
+    {
+        m_fds.fill(-1);
+        if (!enabled)
+            return;
+#if defined(__linux__)
+        const auto l1d_read_miss = PERF_COUNT_HW_CACHE_L1D | (PERF_COUNT_HW_CACHE_OP_READ << 8) |
+                                   (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+        open(counter::cycles, PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES);
+        open(counter::instructions, PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS);
+        open(counter::stalled_cycles_backend, PERF_TYPE_HARDWARE, PERF_COUNT_HW_STALLED_CYCLES_BACKEND);
+        open(counter::l1d_misses, PERF_TYPE_HW_CACHE, l1d_read_miss);
+        open(counter::llc_misses, PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES);
+        open(counter::page_faults, PERF_TYPE_SOFTWARE, PERF_COUNT_SW_PAGE_FAULTS);
+#endif
+    }
+
+    ~perf_counters()
+    {
+#if defined(__linux__)
+        for (int fd : m_fds)
+            if (fd >= 0)
+                close(fd);
+#endif
+    }
+
+    perf_counters(const perf_counters&) = delete;
+    perf_counters& operator=(const perf_counters&) = delete;
+
+    bool available(counter c) const { return m_fds[index(c)] >= 0; }
+
+    bool any_available() const
+    {
+        for (int fd : m_fds)
+            if (fd >= 0)
+                return true;
+        return false;
+    }
+
+    bool any_hardware() const { return available(counter::cycles) || available(counter::instructions); }
+
+    // Zero and start every available counter. RESET does not clear what
+    // threads that have already exited added to an inherited counter, so
+    // the values at the start are read and subtracted by stop().
+    void start()
+    {
+#if defined(__linux__)
+        for (std::size_t k = 0; k < counter_count; ++k)
+            if (m_fds[k] >= 0)
+            {
+                ioctl(m_fds[k], PERF_EVENT_IOC_RESET, 0);
+                read_raw(k, m_start[k]);
+                ioctl(m_fds[k], PERF_EVENT_IOC_ENABLE, 0);
+            }
+#endif
+    }
+
+    // Stop counting and read the values.
+    void stop()
+    {
+#if defined(__linux__)
+        for (int fd : m_fds)
+            if (fd >= 0)
+                ioctl(fd, PERF_EVENT_IOC_DISABLE, 0);
+        for (std::size_t k = 0; k < counter_count; ++k)
+        {
+            m_values[k] = 0;
+            raw now;
+            if (m_fds[k] < 0 || !read_raw(k, now))
+                continue;
+            const auto& then = m_start[k];
+            const double running = static_cast<double>(now.time_running - then.time_running);
+            m_values[k] = running > 0 ? static_cast<double>(now.value - then.value) *
+                                            static_cast<double>(now.time_enabled - then.time_enabled) / running
+                                      : 0;
+        }
+#endif
+    }
+
+    // Value of the last start()/stop() region, 0 if unavailable.
+    double value(counter c) const { return m_values[index(c)]; }
+
+  private:
+    // what read(2) returns for the read_format below
+    struct raw
+    {
+        std::uint64_t value = 0;
+        std::uint64_t time_enabled = 0;
+        std::uint64_t time_running = 0;
+    };
+
+    static std::size_t index(counter c) { return static_cast<std::size_t>(c); }
+
+#if defined(__linux__)
+    void open(counter c, std::uint32_t type, std::uint64_t config)
+    {
+        perf_event_attr attr;
+        std::memset(&attr, 0, sizeof(attr));
+        attr.size = sizeof(attr);
+        attr.type = type;
+        attr.config = config;
+        attr.disabled = 1;
+        attr.exclude_kernel = 1;
+        attr.exclude_hv = 1;
+        attr.inherit = 1;   // incompatible with PERF_FORMAT_GROUP, hence one read per event
+        attr.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+        m_fds[index(c)] = static_cast<int>(syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0));
+    }
+
+    bool read_raw(std::size_t k, raw& out) const
+    {
+        std::uint64_t data[3] = {0, 0, 0};   // value, time_enabled, time_running
+        if (read(m_fds[k], data, sizeof(data)) != static_cast<ssize_t>(sizeof(data)))
+            return false;
+        out = {data[0], data[1], data[2]};
+        return true;
+    }
+#endif
+
+    std::array<int, counter_count> m_fds{};
+    std::array<raw, counter_count> m_start{};
+    std::array<double, counter_count> m_values{};
+};
+
+// Counts for as long as it lives.
+class perf_scope
+{
+  public:
+    explicit perf_scope(perf_counters& counters) : m_counters(counters) { m_counters.start(); }
+    ~perf_scope() { m_counters.stop(); }
+
+    perf_scope(const perf_scope&) = delete;
+    perf_scope& operator=(const perf_scope&) = delete;
+
+  private:
+    perf_counters& m_counters;
+};
+
+} // namespace bench
@@ -0,0 +1,140 @@
+#pragma once
+
+// A fork/join pool of long lived threads for the benchmarks that run
+// the same work on several cores: the parallel traversal
+// (parallel_traversal.h), the shared_ptr hand-offs and the parallel
+// algorithms of lambda/.
+//
+// Worker w is pinned to CPU w of the CPUs this process may run on
+// (sched_getaffinity, so taskset and cgroup limits are respected), so
+// that the OS does not migrate it away from its caches and its memory
+// in the middle of a measurement. Pinning is Linux only; elsewhere the
+// threads just run unpinned.
+
+#include <algorithm>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#if defined(__linux__)
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+namespace bench {
+
+// CPUs this process is allowed to run on, in order.
+inline std::vector<int> available_cpus()
+{
+    std::vector<int> cpus;
+#if defined(__linux__)
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    if (sched_getaffinity(0, sizeof(set), &set) == 0)
+        for (int cpu = 0; cpu < CPU_SETSIZE; ++cpu)
+            if (CPU_ISSET(cpu, &set))
+                cpus.push_back(cpu);
+#endif
+    if (cpus.empty())
+        for (unsigned cpu = 0; cpu < std::max(1u, std::thread::hardware_concurrency()); ++cpu)
+            cpus.push_back(static_cast<int>(cpu));
+    return cpus;
+}
+
+inline bool pin_thread(std::thread& thread, int cpu)
+{
+#if defined(__linux__)
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(cpu, &set);
+    return pthread_setaffinity_np(thread.native_handle(), sizeof(set), &set) == 0;
+#else
+    (void)thread;
+    (void)cpu;
+    return false;
+#endif
+}
+
+// A fork/join pool of long lived (optionally pinned) threads: run(job)
+// calls job(worker) once on every worker and returns when all are done.
+// Cheap enough to call per traversal, unlike spawning threads every time.
+class pinned_pool
+{
+  public:
+    explicit pinned_pool(unsigned threads, bool pin = true)
+    {
+        const auto cpus = available_cpus();
+        threads = std::max(1u, threads);
+        m_threads.reserve(threads);
+        for (unsigned w = 0; w < threads; ++w)
+        {
+            m_threads.emplace_back([this, w] { work(w); });
+            if (pin)
+                pin_thread(m_threads.back(), cpus[w % cpus.size()]);
+        }
+    }
+
+    ~pinned_pool()
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_stop = true;
+        }
+        m_start.notify_all();
+        for (auto& thread : m_threads)
+            thread.join();
+    }
+
+    pinned_pool(const pinned_pool&) = delete;
+    pinned_pool& operator=(const pinned_pool&) = delete;
+
+    unsigned size() const { return static_cast<unsigned>(m_threads.size()); }
+
+    void run(const std::function<void(unsigned)>& job)
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_job = &job;
+        m_pending = size();
+        ++m_generation;
+        m_start.notify_all();
+        m_done.wait(lock, [this] { return m_pending == 0; });
+        m_job = nullptr;
+    }
+
+  private:
+    void work(unsigned worker)
+    {
+        unsigned long seen = 0;
+        for (;;)
+        {
+            const std::function<void(unsigned)>* job;
+            {
+                std::unique_lock<std::mutex> lock(m_mutex);
+                m_start.wait(lock, [&] { return m_stop || m_generation != seen; });
+                if (m_stop)
+                    return;
+                seen = m_generation;
+                job = m_job;
+            }
+            (*job)(worker);
+            {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                if (--m_pending == 0)
+                    m_done.notify_one();
+            }
+        }
+    }
+
+    std::vector<std::thread> m_threads;
+    std::mutex m_mutex;
+    std::condition_variable m_start;
+    std::condition_variable m_done;
+    const std::function<void(unsigned)>* m_job = nullptr;
+    unsigned long m_generation = 0;
+    unsigned m_pending = 0;
+    bool m_stop = false;
+};
+
+} // namespace bench
@@ -0,0 +1,128 @@
+// lambdas.cpp's foreach and foreach_1, over --elements=N ints (default
+// 10^8), with the callable passed five ways:
+//
+//   function_pointer   foreach(values, void (*)(int)): no captures, so
+//                      the result goes to a global
+//   std_function       foreach_1(values, const function<void(int)>&)
+//   function_ref       function_ref<void(int)> (function_ref.h)
+//   inplace_function   const inplace_function<void(int)>& (inplace_function.h)
+//   template_param     template <typename F> foreach(values, F&& func):
+//                      the lambda's type is known, so it is inlined
+//
+// Every foreach is compiled as if it were in another translation unit
+// (BENCH_NOIPA); only the template one sees the lambda's body.
+//
+// wrap_and_call: a lambda capturing three references (24 bytes, more
+// than std::function keeps in place) wrapped anew for every call of a
+// foreach over 16 values, like a callback built per event. ns/item is
+// per wrap and call.
+
+#include "bench.h"
+#include "function_ref.h"
+#include "inplace_function.h"
+
+#include <cstdint>
+#include <functional>
+#include <numeric>
+#include <vector>
+
+std::int64_t g_sum = 0;
+
+void add_to_sum(int value)
+{
+    g_sum += value;
+}
+
+BENCH_NOIPA void foreach(const std::vector<int>& values, void (*func)(int))
+{
+    for (auto value : values)
+        func(value);
+}
+
+BENCH_NOIPA void foreach_1(const std::vector<int>& values, const std::function<void(int)>& func)
+{
+    for (auto value : values)
+        func(value);
+}
+
+BENCH_NOIPA void foreach_ref(const std::vector<int>& values, function_ref<void(int)> func)
+{
+    for (auto value : values)
+        func(value);
+}
+
+BENCH_NOIPA void foreach_inplace(const std::vector<int>& values, const inplace_function<void(int)>& func)
+{
+    for (auto value : values)
+        func(value);
+}
+
+template <typename F>
+BENCH_NOINLINE void foreach_template(const std::vector<int>& values, F&& func)
+{
+    for (auto value : values)
+        func(value);
+}
+
+int main(int argc, char** argv)
+{
+    bench::runner r("callable", argc, argv);
+
+    const auto elements = static_cast<std::size_t>(r.param("elements", r.size(100000000L, 100000L)));
+    std::vector<int> values(elements);
+    std::iota(values.begin(), values.end(), 0);
+
+    std::int64_t sum = 0;
+    auto add = [&sum](int value) { sum += value; };
+
+    r.run("foreach", "function_pointer", elements, [&] {
+        foreach(values, add_to_sum);
+        bench::do_not_optimize(g_sum);
+    });
+    r.run("foreach", "std_function", elements, [&] {
+        foreach_1(values, add);
+        bench::do_not_optimize(sum);
+    });
+    r.run("foreach", "function_ref", elements, [&] {
+        foreach_ref(values, add);
+        bench::do_not_optimize(sum);
+    });
+    r.run("foreach", "inplace_function", elements, [&] {
+        foreach_inplace(values, add);
+        bench::do_not_optimize(sum);
+    });
+    r.run("foreach", "template_param", elements, [&] {
+        foreach_template(values, add);
+        bench::do_not_optimize(sum);
+    });
+
+    const std::size_t calls = r.size(1000000, 10000);
+    const std::vector<int> event(16, 1);
+    std::int64_t a = 0, b = 0, c = 0;
+    // every call gets a fresh callable, as a std::function parameter
+    // built from a lambda at the call site does
+    r.run("wrap_and_call", "std_function", calls, [&] {
+        for (std::size_t i = 0; i < calls; ++i)
+            foreach_1(event, [&a, &b, &c](int value) { a += value, b -= value, c ^= value; });
+        bench::do_not_optimize(a);
+    });
+    r.run("wrap_and_call", "function_ref", calls, [&] {
+        for (std::size_t i = 0; i < calls; ++i)
+            foreach_ref(event, [&a, &b, &c](int value) { a += value, b -= value, c ^= value; });
+        bench::do_not_optimize(a);
+    });
+    r.run("wrap_and_call", "inplace_function", calls, [&] {
+        for (std::size_t i = 0; i < calls; ++i)
+            foreach_inplace(event, [&a, &b, &c](int value) { a += value, b -= value, c ^= value; });
+        bench::do_not_optimize(a);
+    });
+    r.run("wrap_and_call", "template_param", calls, [&] {
+        for (std::size_t i = 0; i < calls; ++i)
+            foreach_template(event, [&a, &b, &c](int value) { a += value, b -= value, c ^= value; });
+        bench::do_not_optimize(a);
+    });
+    bench::do_not_optimize(b);
+    bench::do_not_optimize(c);
+
+    return r.finish();
+}
@@ -0,0 +1,115 @@
+// What function_ref.h and inplace_function.h promise, checked: neither
+// allocates, whatever the lambda captures (within the capacity). And
+// that all of them call the same lambda the same way. Runs as part of
+// the build; any difference fails it.
+//
+// std::function's allocations are only printed: when its small buffer
+// runs out is up to the standard library (16 bytes in libstdc++, three
+// pointers in libc++).
+
+#include "alloc_counter.h"
+#include "bench.h"
+#include "function_ref.h"
+#include "inplace_function.h"
+
+#include <cstdio>
+#include <functional>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace {
+
+int g_checks = 0;
+int g_failures = 0;
+
+void check(const char* what, std::size_t actual, std::size_t expected)
+{
+    ++g_checks;
+    if (actual == expected)
+        return;
+    ++g_failures;
+    std::fprintf(stderr, "FAILED: %s: %zu, expected %zu\n", what, actual, expected);
+}
+
+void foreach_1(const std::vector<int>& values, const std::function<void(int)>& func)
+{
+    for (auto value : values)
+        func(value);
+}
+
+void foreach_ref(const std::vector<int>& values, function_ref<void(int)> func)
+{
+    for (auto value : values)
+        func(value);
+}
+
+void foreach_inplace(const std::vector<int>& values, const inplace_function<void(int)>& func)
+{
+    for (auto value : values)
+        func(value);
+}
+
+long g_total = 0;
+
+void add_to_total(int value)
+{
+    g_total += value;
+}
+
+} // namespace
+
+int main()
+{
+    const std::vector<int> values = {1, 2, 3, 4, 5};
+    long a = 0, b = 0, c = 0;
+    auto small = [&a](int value) { a += value; };                            // 8 bytes
+    auto big = [&a, &b, &c](int value) { a += value, b += 2 * value, c += 3 * value; };   // 24 bytes
+
+    {
+        bench::alloc_scope scope;
+        foreach_1(values, small);
+        std::printf("std::function, 8 bytes of captures: %zu allocations\n", scope.allocations());
+    }
+    {
+        bench::alloc_scope scope;
+        foreach_1(values, big);
+        std::printf("std::function, 24 bytes of captures: %zu allocations\n", scope.allocations());
+    }
+    {
+        bench::alloc_scope scope;
+        foreach_ref(values, big);
+        foreach_ref(values, add_to_total);
+        check("function_ref: allocations", scope.allocations(), 0);
+    }
+    {
+        bench::alloc_scope scope;
+        foreach_inplace(values, big);
+        inplace_function<void(int)> stored = big;
+        inplace_function<void(int)> copy = stored;
+        inplace_function<void(int)> moved = std::move(copy);
+        stored = moved;
+        stored(1);
+        check("inplace_function, construct/copy/move/assign: allocations", scope.allocations(), 0);
+    }
+    check("calls through every wrapper: a", static_cast<std::size_t>(a), 4 * 15 + 1);
+    check("calls through every wrapper: c", static_cast<std::size_t>(c), 3 * (3 * 15 + 1));
+    check("function_ref to a plain function", static_cast<std::size_t>(g_total), 15);
+
+    // a callable that owns something: copies and destruction are real
+    {
+        std::string name = "a name too long for the small string buffer";
+        std::size_t length = 0;
+        inplace_function<void(int), 48> f = [name, &length](int) { length += name.size(); };
+        auto g = f;
+        f = inplace_function<void(int), 48>();
+        g(0);
+        check("inplace_function owning a std::string", length, name.size());
+        check("inplace_function emptied by assignment", static_cast<bool>(f), 0);
+    }
+
+    if (g_failures)
+        return 1;
+    std::printf("callable_check: %d checks passed\n", g_checks);
+    return 0;
+}
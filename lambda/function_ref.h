@@ -0,0 +1,66 @@
+#pragma once
+
+// A non-owning reference to anything callable as R(Args...): a lambda,
+// with or without captures, a function pointer, a functor. For
+// parameters like foreach_1's in lambdas.cpp, where the callable is
+// only used during the call:
+//
+//   void foreach_2(const vector<int>& values, function_ref<void(int)> func);
+//   foreach_2(values, [&a](int value) { ... });
+//
+// const function<void(int)>& makes a std::function out of the lambda
+// first (on the heap if its captures do not fit the small buffer,
+// 16 bytes in libstdc++) and then calls through it. function_ref is two
+// pointers, the object and a thunk that knows its type: nothing is
+// copied or allocated, and a call is one indirect call, like the
+// function pointer of `foreach`.
+//
+// It does not own what it refers to: like a string_view, it must not
+// outlive the callable (a function_ref member or a returned one almost
+// always dangles). To store a callable, use inplace_function.h or
+// std::function.
+
+#include <functional>
+#include <type_traits>
+#include <utility>
+
+template <typename Signature>
+class function_ref;
+
+template <typename R, typename... Args>
+class function_ref<R(Args...)>
+{
+  public:
+    template <typename F, typename = std::enable_if_t<!std::is_same_v<std::decay_t<F>, function_ref> &&
+                                                      std::is_invocable_r_v<R, F&, Args...>>>
+    function_ref(F&& f) noexcept
+    {
+        if constexpr (std::is_function_v<std::remove_pointer_t<std::decay_t<F>>>)
+        {
+            // a plain function (pointer): keep the pointer itself
+            m_storage.function = reinterpret_cast<void (*)()>(static_cast<std::decay_t<F>>(f));
+            m_thunk = [](storage s, Args... args) -> R {
+                return std::invoke(reinterpret_cast<std::decay_t<F>>(s.function), std::forward<Args>(args)...);
+            };
+        }
+        else
+        {
+            m_storage.object = const_cast<void*>(static_cast<const void*>(std::addressof(f)));
+            m_thunk = [](storage s, Args... args) -> R {
+                return std::invoke(*static_cast<std::remove_reference_t<F>*>(s.object), std::forward<Args>(args)...);
+            };
+        }
+    }
+
+    R operator()(Args... args) const { return m_thunk(m_storage, std::forward<Args>(args)...); }
+
+  private:
+    union storage
+    {
+        void* object;
+        void (*function)();
+    };
+
+    storage m_storage;
+    R (*m_thunk)(storage, Args...);
+};
@@ -0,0 +1,118 @@
+#pragma once
+
+// std::function that never allocates: the callable is stored in a
+// buffer of Capacity bytes inside the object, and one that does not fit
+// is a compile error instead of a heap allocation.
+//
+//   int a = 5;
+//   inplace_function<void(int)> f = [&a](int value) { ... };   // 8 bytes of captures
+//   std::vector<inplace_function<void(int), 64>> handlers;       // stored, copied, called
+//
+// std::function in libstdc++ keeps callables of up to 16 bytes (and
+// only trivially copyable ones, more or less) in place; a lambda that
+// captures three pointers or a std::string already goes to the heap,
+// once per construction and once per copy. Here the size is part of the
+// type, so how much every callable may capture is decided up front.
+//
+// Otherwise it behaves like std::function: owning, copyable, empty by
+// default, type erased, one indirect call per call. For a callable that
+// is only passed down and used during a call, function_ref.h is
+// cheaper still (nothing is copied).
+
+#include <cstddef>
+#include <functional>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+template <typename Signature, std::size_t Capacity = 32, std::size_t Alignment = alignof(std::max_align_t)>
+class inplace_function;
+
+template <typename R, typename... Args, std::size_t Capacity, std::size_t Alignment>
+class inplace_function<R(Args...), Capacity, Alignment>
+{
+  public:
+    inplace_function() noexcept = default;
+
+    template <typename F, typename = std::enable_if_t<!std::is_same_v<std::decay_t<F>, inplace_function> &&
+                                                      std::is_invocable_r_v<R, std::decay_t<F>&, Args...>>>
+    inplace_function(F&& f)
+    {
+        using stored = std::decay_t<F>;
+        static_assert(sizeof(stored) <= Capacity, "callable too big for this inplace_function: raise Capacity");
+        static_assert(Alignment % alignof(stored) == 0, "callable too strictly aligned for this inplace_function");
+        static_assert(std::is_copy_constructible_v<stored>, "inplace_function needs a copyable callable");
+        static_assert(std::is_nothrow_move_constructible_v<stored>, "inplace_function moves must not throw");
+        ::new (static_cast<void*>(&m_buffer)) stored(std::forward<F>(f));
+        m_ops = &ops_for<stored>;
+    }
+
+    inplace_function(const inplace_function& other) : m_ops(other.m_ops)
+    {
+        if (m_ops)
+            m_ops->copy(&m_buffer, &other.m_buffer);
+    }
+
+    inplace_function(inplace_function&& other) noexcept : m_ops(std::exchange(other.m_ops, nullptr))
+    {
+        if (m_ops)
+            m_ops->move(&m_buffer, &other.m_buffer);
+    }
+
+    inplace_function& operator=(inplace_function other) noexcept
+    {
+        reset();
+        if (other.m_ops)
+        {
+            other.m_ops->move(&m_buffer, &other.m_buffer);
+            m_ops = std::exchange(other.m_ops, nullptr);
+        }
+        return *this;
+    }
+
+    ~inplace_function() { reset(); }
+
+    R operator()(Args... args) const
+    {
+        if (!m_ops)
+            throw std::bad_function_call();
+        return m_ops->invoke(&m_buffer, std::forward<Args>(args)...);
+    }
+
+    explicit operator bool() const noexcept { return m_ops != nullptr; }
+
+  private:
+    struct ops
+    {
+        R (*invoke)(const void* callable, Args... args);
+        void (*copy)(void* to, const void* from);
+        void (*move)(void* to, void* from) noexcept;   // and destroys `from`
+        void (*destroy)(void* callable) noexcept;
+    };
+
+    // One table per stored type, like a vtable, so the object is the
+    // buffer plus one pointer.
+    template <typename F>
+    static constexpr ops ops_for{
+        [](const void* callable, Args... args) -> R {
+            // std::function calls its target as non-const too
+            return std::invoke(*const_cast<F*>(static_cast<const F*>(callable)), std::forward<Args>(args)...);
+        },
+        [](void* to, const void* from) { ::new (to) F(*static_cast<const F*>(from)); },
+        [](void* to, void* from) noexcept {
+            ::new (to) F(std::move(*static_cast<F*>(from)));
+            static_cast<F*>(from)->~F();
+        },
+        [](void* callable) noexcept { static_cast<F*>(callable)->~F(); },
+    };
+
+    void reset() noexcept
+    {
+        if (m_ops)
+            m_ops->destroy(&m_buffer);
+        m_ops = nullptr;
+    }
+
+    alignas(Alignment) unsigned char m_buffer[Capacity];
+    const ops* m_ops = nullptr;
+};
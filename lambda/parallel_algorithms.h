@@ -0,0 +1,169 @@
+#pragma once
+
+// Parallel versions of lambdas.cpp's foreach and find_if, taking the
+// same lambdas:
+//
+//   bench::pinned_pool pool(bench::available_cpus().size());
+//   parallel_for_each(pool, values.begin(), values.end(), [](int value) { ... });
+//   auto it = parallel_find_if(pool, values.begin(), values.end(), [](int value) { return value > 3; });
+//
+// The range is cut into chunks (of `grain` elements; by default some
+// eight per worker, at least min_grain). Every worker of the pool
+// (benchmark/pinned_pool.h) starts on its own contiguous share of the
+// chunks and takes them front to back; a worker that runs out steals
+// the back half of what another one has left. So an uneven lambda
+// (some values much more work than others) or a worker that gets
+// descheduled does not leave the others idle at the end.
+//
+// parallel_find_if returns the same element std::find_if would, the
+// first match. Once any worker has found a match at position p, chunks
+// that start after p are skipped: with the first match early in the
+// range, the work done is about what the sequential search does, spread
+// over the workers.
+//
+// Waking the pool costs some microseconds, so below a certain size the
+// sequential loop wins (parallel_algorithms_bench prints where). The
+// lambda is called from several threads at once; what it writes to must
+// be per element or synchronized (the printing lambdas of lambdas.cpp
+// would interleave their output).
+
+#include "pinned_pool.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <memory>
+
+// Hands out chunk indices [0, chunks) to `workers` workers, each with its
+// own range to take from the front and to be stolen from at the back.
+class chunk_scheduler
+{
+  public:
+    chunk_scheduler(std::size_t chunks, unsigned workers)
+        : m_workers(workers), m_ranges(std::make_unique<range[]>(workers))
+    {
+        for (unsigned w = 0; w < workers; ++w)
+            m_ranges[w].bounds.store(pack(chunks * w / workers, chunks * (w + 1) / workers),
+                                     std::memory_order_relaxed);
+    }
+
+    // The next chunk for `worker`, from its own range or stolen; false
+    // when every range is empty.
+    bool next(unsigned worker, std::size_t& chunk)
+    {
+        return take_own(worker, chunk) || steal(worker, chunk);
+    }
+
+  private:
+    // begin in the high half, end in the low half, so that one CAS
+    // updates both
+    struct alignas(64) range
+    {
+        std::atomic<std::uint64_t> bounds{0};
+    };
+
+    static std::uint64_t pack(std::size_t begin, std::size_t end) { return (std::uint64_t(begin) << 32) | end; }
+    static std::size_t begin_of(std::uint64_t bounds) { return static_cast<std::size_t>(bounds >> 32); }
+    static std::size_t end_of(std::uint64_t bounds) { return static_cast<std::size_t>(bounds & 0xffffffffu); }
+
+    bool take_own(unsigned worker, std::size_t& chunk)
+    {
+        auto& bounds = m_ranges[worker].bounds;
+        std::uint64_t b = bounds.load(std::memory_order_relaxed);
+        while (begin_of(b) < end_of(b))
+            if (bounds.compare_exchange_weak(b, pack(begin_of(b) + 1, end_of(b)), std::memory_order_relaxed))
+            {
+                chunk = begin_of(b);
+                return true;
+            }
+        return false;
+    }
+
+    // Takes the back half of the first non-empty range after our own:
+    // its first chunk to run now, the rest becomes our range.
+    bool steal(unsigned worker, std::size_t& chunk)
+    {
+        for (unsigned i = 1; i < m_workers; ++i)
+        {
+            auto& victim = m_ranges[(worker + i) % m_workers].bounds;
+            std::uint64_t b = victim.load(std::memory_order_relaxed);
+            while (begin_of(b) < end_of(b))
+            {
+                const std::size_t mid = begin_of(b) + (end_of(b) - begin_of(b)) / 2;
+                if (victim.compare_exchange_weak(b, pack(begin_of(b), mid), std::memory_order_relaxed))
+                {
+                    chunk = mid;
+                    m_ranges[worker].bounds.store(pack(mid + 1, end_of(b)), std::memory_order_relaxed);
+                    return true;
+                }
+            }
+        }
+        return false;
+    }
+
+    unsigned m_workers;
+    std::unique_ptr<range[]> m_ranges;
+};
+
+constexpr std::size_t min_grain = 4096;
+
+inline std::size_t default_grain(std::size_t n, unsigned workers)
+{
+    return std::max(min_grain, n / (8 * std::size_t(workers)) + 1);
+}
+
+// f(*it) for every element, on all workers of the pool.
+template <typename It, typename F>
+void parallel_for_each(bench::pinned_pool& pool, It first, It last, F&& f, std::size_t grain = 0)
+{
+    const auto n = static_cast<std::size_t>(std::distance(first, last));
+    if (n == 0)
+        return;
+    if (grain == 0)
+        grain = default_grain(n, pool.size());
+    chunk_scheduler chunks((n + grain - 1) / grain, pool.size());
+    pool.run([&](unsigned worker) {
+        std::size_t chunk;
+        while (chunks.next(worker, chunk))
+        {
+            const std::size_t begin = chunk * grain;
+            const std::size_t end = std::min(n, begin + grain);
+            std::for_each(first + begin, first + end, f);
+        }
+    });
+}
+
+// The first element for which pred is true, or last; all workers search.
+template <typename It, typename Pred>
+It parallel_find_if(bench::pinned_pool& pool, It first, It last, Pred&& pred, std::size_t grain = 0)
+{
+    const auto n = static_cast<std::size_t>(std::distance(first, last));
+    if (n == 0)
+        return last;
+    if (grain == 0)
+        grain = default_grain(n, pool.size());
+    chunk_scheduler chunks((n + grain - 1) / grain, pool.size());
+    std::atomic<std::size_t> found{n};   // lowest matching position so far
+    pool.run([&](unsigned worker) {
+        std::size_t chunk;
+        while (chunks.next(worker, chunk))
+        {
+            const std::size_t begin = chunk * grain;
+            // a match before this chunk is already known: nothing here can be first
+            if (begin >= found.load(std::memory_order_relaxed))
+                continue;
+            const std::size_t end = std::min(n, begin + grain);
+            const It hit = std::find_if(first + begin, first + end, pred);
+            if (hit == first + end)
+                continue;
+            const auto pos = static_cast<std::size_t>(hit - first);
+            std::size_t best = found.load(std::memory_order_relaxed);
+            while (pos < best && !found.compare_exchange_weak(best, pos, std::memory_order_relaxed))
+            {
+            }
+        }
+    });
+    return first + found.load(std::memory_order_relaxed);
+}
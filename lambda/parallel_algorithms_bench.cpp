@@ -0,0 +1,129 @@
+// lambdas.cpp's foreach and find_if, sequential against the chunked,
+// work stealing versions of parallel_algorithms.h, for vector sizes
+// 10^3 .. 10^8 (10^5 with --quick):
+//
+// foreach_N    a light lambda updating every element in place
+//              (value = value * 7 + 3, unsigned so that wrapping over
+//              the repetitions is defined): memory bound at large sizes
+// find_if_N    iota values, find_if(value > N / 10): the first match a
+//              tenth into the vector, where early exit pays off
+// find_none_N  no match at all: both read the whole vector
+//
+// --threads=N sets the pool size (default: the CPUs this process may
+// run on), --pin=0 turns pinning off. After the runs the smallest size
+// at which the parallel version beat the sequential one is printed per
+// algorithm: the crossover below which the pool's wake-up costs more
+// than it saves.
+
+#include "bench.h"
+#include "parallel_algorithms.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <numeric>
+#include <string>
+#include <vector>
+
+double median_per_item(const bench::runner& r, const std::string& group, const std::string& name)
+{
+    for (const auto& result : r.results())
+        if (result.group == group && result.name == name)
+            return result.ns.median / result.items;
+    return 0;
+}
+
+int main(int argc, char** argv)
+{
+    bench::runner r("parallel_algorithms", argc, argv);
+
+    const auto threads =
+        static_cast<unsigned>(std::max(1L, r.param("threads", static_cast<long>(bench::available_cpus().size()))));
+    const bool pin = r.param("pin", 1) != 0;
+    const std::size_t largest = r.size(100000000, 100000);
+
+    bench::pinned_pool pool(threads, pin);
+    std::vector<std::size_t> sizes;
+    for (std::size_t n = 1000; n <= largest; n *= 10)
+        sizes.push_back(n);
+
+    for (std::size_t n : sizes)
+    {
+        const std::string suffix = '_' + std::to_string(n);
+        // Each algorithm's result is checked before it is measured: a
+        // wrong answer is not a result.
+        {
+            std::vector<std::uint32_t> values(n);
+            std::iota(values.begin(), values.end(), 0u);
+            auto update = [](std::uint32_t& value) { value = value * 7 + 3; };
+
+            parallel_for_each(pool, values.begin(), values.end(), update);
+            for (std::size_t i = 0; i < n; ++i)
+                if (values[i] != static_cast<std::uint32_t>(i) * 7 + 3)
+                {
+                    std::fprintf(stderr, "parallel_for_each missed element %zu\n", i);
+                    return 1;
+                }
+
+            r.run("foreach" + suffix, "sequential", n, [&] {
+                std::for_each(values.begin(), values.end(), update);
+                bench::clobber_memory();
+            });
+            r.run("foreach" + suffix, "parallel", n, [&] {
+                parallel_for_each(pool, values.begin(), values.end(), update);
+                bench::clobber_memory();
+            });
+        }
+
+        std::vector<int> values(n);
+        std::iota(values.begin(), values.end(), 0);
+        const int threshold = static_cast<int>(n / 10);
+        auto above = [threshold](int value) { return value > threshold; };
+        auto negative = [](int value) { return value < 0; };
+        if (parallel_find_if(pool, values.begin(), values.end(), above) !=
+                std::find_if(values.begin(), values.end(), above) ||
+            parallel_find_if(pool, values.begin(), values.end(), negative) != values.end())
+        {
+            std::fprintf(stderr, "parallel_find_if did not return the first match\n");
+            return 1;
+        }
+
+        r.run("find_if" + suffix, "sequential", n, [&] {
+            bench::do_not_optimize(std::find_if(values.begin(), values.end(), above));
+        });
+        r.run("find_if" + suffix, "parallel", n, [&] {
+            bench::do_not_optimize(parallel_find_if(pool, values.begin(), values.end(), above));
+        });
+
+        r.run("find_none" + suffix, "sequential", n, [&] {
+            bench::do_not_optimize(std::find_if(values.begin(), values.end(), negative));
+        });
+        r.run("find_none" + suffix, "parallel", n, [&] {
+            bench::do_not_optimize(parallel_find_if(pool, values.begin(), values.end(), negative));
+        });
+    }
+
+    std::printf("  crossover with %u threads:", pool.size());
+    for (const std::string algorithm : {"foreach", "find_if", "find_none"})
+    {
+        std::size_t crossover = 0;
+        for (std::size_t n : sizes)
+        {
+            std::string group = algorithm;
+            group += '_';
+            group += std::to_string(n);
+            if (median_per_item(r, group, "parallel") < median_per_item(r, group, "sequential"))
+            {
+                crossover = n;
+                break;
+            }
+        }
+        if (crossover)
+            std::printf("  %s from %zu", algorithm.c_str(), crossover);
+        else
+            std::printf("  %s never", algorithm.c_str());
+    }
+    std::printf("\n");
+
+    return r.finish();
+}
@@ -0,0 +1,252 @@
+#pragma once
+
+// Lazy, fused pipelines of lambdas over a range:
+//
+//   using namespace lazy;
+//   long total = from(values)
+//              | filter([](int value) { return value % 3 == 0; })
+//              | map([](int value) { return long(value) * value; })
+//              | take(1000)
+//              | reduce(0L, std::plus<>());
+//
+// The same chain written with the algorithms of lambdas.cpp runs once
+// per step and materializes every step in between: copy_if into a
+// temporary vector, transform into another one, then accumulate a
+// prefix of it. Every element is written out and read back once per
+// step, the temporaries are allocated (and grown) on every run, and
+// take() cannot stop the earlier steps from going through the whole
+// input.
+//
+// Here nothing runs until the terminal step (reduce, for_each,
+// to_vector). Then the stages are nested into one function per element,
+// innermost the terminal, and the source is walked once: an element
+// goes through filter, map and reduce while it is still in a register,
+// no temporary exists, and a take() that is satisfied stops the walk.
+//
+// A pipeline keeps a reference to its source range and copies of the
+// lambdas; build and run it in one expression (or keep the range alive).
+
+#include <cstddef>
+#include <functional>
+#include <iterator>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace lazy {
+
+// Stages. wrap(down) turns the sink downstream of the stage into the sink
+// the stage presents upstream. A sink takes an element and returns
+// whether it wants more. output<In> is what the stage passes on when
+// given an In.
+template <typename Pred>
+struct filter_stage
+{
+    template <typename In>
+    using output = In;
+
+    Pred pred;
+    template <typename Down>
+    auto wrap(Down down) const
+    {
+        return [pred = pred, down](auto&& value) mutable {
+            return pred(value) ? down(std::forward<decltype(value)>(value)) : true;
+        };
+    }
+};
+
+template <typename F>
+struct map_stage
+{
+    template <typename In>
+    using output = std::decay_t<std::invoke_result_t<const F&, In>>;
+
+    F f;
+    template <typename Down>
+    auto wrap(Down down) const
+    {
+        return [f = f, down](auto&& value) mutable { return down(f(std::forward<decltype(value)>(value))); };
+    }
+};
+
+struct take_stage
+{
+    template <typename In>
+    using output = In;
+
+    std::size_t count;
+    template <typename Down>
+    auto wrap(Down down) const
+    {
+        return [remaining = count, down](auto&& value) mutable {
+            if (remaining == 0)
+                return false;
+            --remaining;
+            return down(std::forward<decltype(value)>(value)) && remaining != 0;
+        };
+    }
+};
+
+// Terminal steps: run the pipeline.
+template <typename T, typename Op>
+struct reduce_step
+{
+    T init;
+    Op op;
+};
+
+template <typename F>
+struct for_each_step
+{
+    F f;
+};
+
+struct to_vector_step
+{
+};
+
+// The type coming out of Stages..., given In going in.
+template <typename In, typename... Stages>
+struct output_of
+{
+    using type = In;
+};
+
+template <typename In, typename First, typename... Rest>
+struct output_of<In, First, Rest...>
+{
+    using type = typename output_of<typename First::template output<In>, Rest...>::type;
+};
+
+template <typename Range, typename... Stages>
+class pipeline
+{
+  public:
+    using value_type =
+        typename output_of<std::decay_t<decltype(*std::begin(std::declval<const Range&>()))>, Stages...>::type;
+
+    pipeline(const Range& range, std::tuple<Stages...> stages) : m_range(&range), m_stages(std::move(stages)) {}
+
+    template <typename Stage>
+    auto then(Stage stage) const
+    {
+        return pipeline<Range, Stages..., Stage>(*m_range, std::tuple_cat(m_stages, std::make_tuple(std::move(stage))));
+    }
+
+    // Walks the source once, pushing every element through the stages
+    // into `sink`, until the range ends or a stage has had enough.
+    template <typename Sink>
+    void run(Sink sink) const
+    {
+        auto chain = wrap<sizeof...(Stages)>(std::move(sink));
+        for (auto&& value : *m_range)
+            if (!chain(value))
+                break;
+    }
+
+  private:
+    // stage I - 1 around the sink, then stage I - 2 around that, ...
+    template <std::size_t I, typename Sink>
+    auto wrap(Sink sink) const
+    {
+        if constexpr (I == 0)
+            return sink;
+        else
+            return wrap<I - 1>(std::get<I - 1>(m_stages).wrap(std::move(sink)));
+    }
+
+    const Range* m_range;
+    std::tuple<Stages...> m_stages;
+};
+
+template <typename Range>
+pipeline<Range> from(const Range& range)
+{
+    return pipeline<Range>(range, {});
+}
+
+template <typename Pred>
+filter_stage<Pred> filter(Pred pred)
+{
+    return {std::move(pred)};
+}
+
+template <typename F>
+map_stage<F> map(F f)
+{
+    return {std::move(f)};
+}
+
+inline take_stage take(std::size_t count)
+{
+    return {count};
+}
+
+template <typename T, typename Op>
+reduce_step<T, Op> reduce(T init, Op op)
+{
+    return {std::move(init), std::move(op)};
+}
+
+template <typename F>
+for_each_step<F> for_each(F f)
+{
+    return {std::move(f)};
+}
+
+inline to_vector_step to_vector()
+{
+    return {};
+}
+
+template <typename Range, typename... Stages, typename Pred>
+auto operator|(const pipeline<Range, Stages...>& p, filter_stage<Pred> stage)
+{
+    return p.then(std::move(stage));
+}
+
+template <typename Range, typename... Stages, typename F>
+auto operator|(const pipeline<Range, Stages...>& p, map_stage<F> stage)
+{
+    return p.then(std::move(stage));
+}
+
+template <typename Range, typename... Stages>
+auto operator|(const pipeline<Range, Stages...>& p, take_stage stage)
+{
+    return p.then(stage);
+}
+
+template <typename Range, typename... Stages, typename T, typename Op>
+T operator|(const pipeline<Range, Stages...>& p, reduce_step<T, Op> step)
+{
+    T result = std::move(step.init);
+    p.run([&](auto&& value) {
+        result = step.op(std::move(result), std::forward<decltype(value)>(value));
+        return true;
+    });
+    return result;
+}
+
+template <typename Range, typename... Stages, typename F>
+void operator|(const pipeline<Range, Stages...>& p, for_each_step<F> step)
+{
+    p.run([&](auto&& value) {
+        step.f(std::forward<decltype(value)>(value));
+        return true;
+    });
+}
+
+template <typename Range, typename... Stages>
+auto operator|(const pipeline<Range, Stages...>& p, to_vector_step)
+{
+    std::vector<typename pipeline<Range, Stages...>::value_type> result;
+    p.run([&](auto&& value) {
+        result.push_back(std::forward<decltype(value)>(value));
+        return true;
+    });
+    return result;
+}
+
+} // namespace lazy
@@ -0,0 +1,115 @@
+// A chain of lambdas over --elements=N ints (default 10^7): keep the
+// multiples of 3, square them (as 64 bit), sum them up; once over
+// everything and once over the first N / 100 that pass the filter.
+//
+//   temporaries   std::copy_if into a vector, std::transform into
+//                 another, std::accumulate (of a prefix, for take): the
+//                 step by step version of lambdas.cpp's algorithms
+//   ranges_views  std::views::filter | transform | take, then a loop:
+//                 lazy as well, pulled through iterators
+//   pipeline      lazy::from | filter | map | take | reduce (pipeline.h):
+//                 pushed through one nested function
+//   hand_loop     the single loop one would write by hand
+//
+// Every run builds its temporaries anew, as a function doing this would.
+// ns/item is per input element in both groups, so the take group shows
+// what stopping early saves.
+
+#include "bench.h"
+#include "pipeline.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <functional>
+#include <numeric>
+#include <ranges>
+#include <vector>
+
+auto multiple_of_3 = [](int value) { return value % 3 == 0; };
+auto square = [](int value) { return std::int64_t(value) * value; };
+
+BENCH_NOINLINE std::int64_t with_temporaries(const std::vector<int>& values, std::size_t count)
+{
+    std::vector<int> kept;
+    std::copy_if(values.begin(), values.end(), std::back_inserter(kept), multiple_of_3);
+    std::vector<std::int64_t> squared(kept.size());
+    std::transform(kept.begin(), kept.end(), squared.begin(), square);
+    const auto end = squared.begin() + static_cast<std::ptrdiff_t>(std::min(count, squared.size()));
+    return std::accumulate(squared.begin(), end, std::int64_t(0));
+}
+
+BENCH_NOINLINE std::int64_t with_ranges_views(const std::vector<int>& values, std::size_t count)
+{
+    std::int64_t sum = 0;
+    for (std::int64_t v : values | std::views::filter(multiple_of_3) | std::views::transform(square) |
+                              std::views::take(count))
+        sum += v;
+    return sum;
+}
+
+BENCH_NOINLINE std::int64_t with_pipeline(const std::vector<int>& values, std::size_t count)
+{
+    using namespace lazy;
+    return from(values) | filter(multiple_of_3) | map(square) | take(count) | reduce(std::int64_t(0), std::plus<>());
+}
+
+BENCH_NOINLINE std::int64_t with_hand_loop(const std::vector<int>& values, std::size_t count)
+{
+    std::int64_t sum = 0;
+    std::size_t taken = 0;
+    for (int value : values)
+    {
+        if (taken == count)
+            break;
+        if (multiple_of_3(value))
+        {
+            sum += square(value);
+            ++taken;
+        }
+    }
+    return sum;
+}
+
+int main(int argc, char** argv)
+{
+    bench::runner r("pipeline", argc, argv);
+
+    const auto n = static_cast<std::size_t>(r.param("elements", r.size(10000000L, 100000L)));
+    std::vector<int> values(n);
+    std::iota(values.begin(), values.end(), 0);
+
+    struct workload
+    {
+        const char* group;
+        std::size_t count;
+    };
+    for (const auto& w : {workload{"filter_map_reduce", n}, workload{"filter_map_take_reduce", n / 100}})
+    {
+        const std::int64_t expected = with_hand_loop(values, w.count);
+        bool agree = true;
+        r.run(w.group, "temporaries", n, [&] { agree &= with_temporaries(values, w.count) == expected; });
+        r.run(w.group, "ranges_views", n, [&] { agree &= with_ranges_views(values, w.count) == expected; });
+        r.run(w.group, "pipeline", n, [&] { agree &= with_pipeline(values, w.count) == expected; });
+        r.run(w.group, "hand_loop", n, [&] { bench::do_not_optimize(with_hand_loop(values, w.count)); });
+        if (!agree)
+        {
+            std::fprintf(stderr, "%s: the versions disagree\n", w.group);
+            return 1;
+        }
+    }
+
+    // to_vector and for_each, the other two ends of a pipeline
+    using namespace lazy;
+    const std::vector<int> small = {1, 2, 3, 4, 5, 6, 7, 8, 9};
+    const auto odd_squares = from(small) | filter([](int v) { return v % 2 == 1; }) | map(square) | to_vector();
+    int seen = 0;
+    from(small) | take(4) | lazy::for_each([&](int) { ++seen; });
+    if (odd_squares != std::vector<std::int64_t>{1, 9, 25, 49, 81} || seen != 4)
+    {
+        std::fprintf(stderr, "to_vector or for_each went wrong\n");
+        return 1;
+    }
+
+    return r.finish();
+}
@@ -0,0 +1,236 @@
+// The allocation, copy and move counts that move_semantics.cpp and
+// On_topic_copying/move/readme.mdt argue about, checked for real.
+//
+// Built twice: once normally and once with -fno-elide-constructors
+// (ELISION_CHECK_NO_ELIDE), where the compiler may no longer elide
+// the copy/move of a named return value (NRVO). Returning a prvalue,
+// as create_example does, is guaranteed elision since C++17 and is not
+// affected by the flag. Both programs run as part of the build and any
+// count that differs from the expected one fails it.
+
+#include "alloc_counter.h"
+#include "bench.h"
+#include "example.h"
+#include "example_before.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <string>
+#include <utility>
+#include <vector>
+
+#ifdef ELISION_CHECK_NO_ELIDE
+constexpr bool elided = false;
+const char* const mode = "-fno-elide-constructors";
+#else
+constexpr bool elided = true;
+const char* const mode = "copy elision";
+#endif
+
+namespace {
+
+int g_checks = 0;
+int g_failures = 0;
+
+void check(const char* what, std::size_t actual, std::size_t expected)
+{
+    ++g_checks;
+    if (actual == expected)
+        return;
+    ++g_failures;
+    std::fprintf(stderr, "FAILED (%s): %s: %zu, expected %zu\n", mode, what, actual, expected);
+}
+
+// example as it was before move semantics: the Rule of Three only, so
+// every would-be move is a deep copy.
+class rule_of_three_example
+{
+  public:
+    explicit rule_of_three_example(std::size_t size) : m_data(new unsigned int[size]), m_size(size) {}
+    rule_of_three_example(const rule_of_three_example& other)
+        : m_data(new unsigned int[other.m_size]), m_size(other.m_size)
+    {
+        std::copy(other.m_data, other.m_data + other.m_size, m_data);
+    }
+    rule_of_three_example& operator=(const rule_of_three_example& other)
+    {
+        if (this == &other)
+            return *this;
+        delete[] m_data;
+        m_data = new unsigned int[other.m_size];
+        std::copy(other.m_data, other.m_data + other.m_size, m_data);
+        m_size = other.m_size;
+        return *this;
+    }
+    ~rule_of_three_example() { delete[] m_data; }
+
+    unsigned int* data() { return m_data; }
+
+  private:
+    unsigned int* m_data;
+    std::size_t m_size;
+};
+
+using counted_example = bench::counted<example>;
+using counted_before = bench::counted<before::example>;
+
+// As in move_semantics.cpp: returns a prvalue.
+BENCH_NOINLINE counted_example create_example(std::size_t size)
+{
+    return counted_example(size);
+}
+
+// Returns a named object: NRVO, or a move when that is disabled.
+BENCH_NOINLINE counted_example create_named_example(std::size_t size)
+{
+    counted_example e(size);
+    e.data()[0] = 1;
+    return e;
+}
+
+// Same, without a move constructor: a copy when NRVO is disabled.
+// (Not wrapped in counted: counted's own move constructor would count
+// the deep copy it falls back to as a move.)
+BENCH_NOINLINE rule_of_three_example create_named_rule_of_three(std::size_t size)
+{
+    rule_of_three_example e(size);
+    e.data()[0] = 1;
+    return e;
+}
+
+// On_topic_copying/move
+struct S
+{
+    S(std::string t_s) : s(std::move(t_s)) {}
+    std::string s;
+};
+
+const char* const long_text = "a string too long for the small string buffer";
+
+void check_create_example()
+{
+    auto& counts = counted_example::counts();
+
+    counts.reset();
+    {
+        bench::alloc_scope scope;
+        counted_example obj6 = create_example(5000);
+        bench::do_not_optimize(obj6.data());
+        check("example obj6 = create_example(5000): allocations", scope.allocations(), 1);
+        check("example obj6 = create_example(5000): copies", counts.copies(), 0);
+        check("example obj6 = create_example(5000): moves", counts.moves(), 0);
+    }
+
+    counts.reset();
+    {
+        counted_example obj6(5000);
+        bench::alloc_scope scope;
+        obj6 = create_example(5000);
+        bench::do_not_optimize(obj6.data());
+        check("obj6 = create_example(5000): allocations", scope.allocations(), 1);
+        check("obj6 = create_example(5000): copies", counts.copies(), 0);
+        check("obj6 = create_example(5000): move assignments", counts.move_assignments, 1);
+    }
+
+    counts.reset();
+    {
+        bench::alloc_scope scope;
+        counted_example e = create_named_example(5000);
+        bench::do_not_optimize(e.data());
+        check("named return of example: allocations", scope.allocations(), 1);
+        check("named return of example: copies", counts.copies(), 0);
+        check("named return of example: moves", counts.moves(), elided ? 0 : 1);
+    }
+
+    {
+        bench::alloc_scope scope;
+        rule_of_three_example e = create_named_rule_of_three(5000);
+        bench::do_not_optimize(e.data());
+        // the "two expensive memory allocations" of move_semantics.cpp
+        check("named return without a move constructor: allocations", scope.allocations(), elided ? 1 : 2);
+    }
+}
+
+void check_example_storage()
+{
+    {
+        bench::alloc_scope scope;
+        example small(example::inline_capacity);
+        bench::do_not_optimize(small.data());
+        check("short example: allocations", scope.allocations(), 0);
+    }
+    {
+        example a(64);
+        const example b(64);
+        bench::alloc_scope scope;
+        a = b;
+        bench::do_not_optimize(a.data());
+        check("copy assignment into a big enough example: allocations", scope.allocations(), 0);
+    }
+    {
+        auto& counts = counted_example::counts();
+        counts.reset();
+        std::vector<counted_example> v;
+        for (int i = 0; i < 100; ++i)
+            v.emplace_back(64);
+        check("std::vector<example> growth: copies", counts.copies(), 0);
+    }
+    {
+        auto& counts = counted_before::counts();
+        counts.reset();
+        std::vector<counted_before> v;
+        for (int i = 0; i < 100; ++i)
+            v.emplace_back(64);
+        // 1 + 2 + 4 + ... + 64 elements relocated by copy, as the move may throw
+        check("std::vector<example before> growth: copies", counts.copies(), 127);
+    }
+}
+
+void check_string_into_S()
+{
+    {
+        std::string s = long_text;
+        bench::alloc_scope scope;
+        S o(s);
+        bench::do_not_optimize(o);
+        check("S o(s): allocations", scope.allocations(), 1);
+    }
+    {
+        std::string s = long_text;
+        bench::alloc_scope scope;
+        S o(std::move(s));
+        bench::do_not_optimize(o);
+        check("S o(std::move(s)): allocations", scope.allocations(), 0);
+    }
+    {
+        std::size_t argument_allocations = 0;
+        {
+            bench::alloc_scope scope;
+            std::string argument = std::string(long_text) + "b";
+            bench::do_not_optimize(argument);
+            argument_allocations = scope.allocations();
+        }
+        bench::alloc_scope scope;
+        S o(std::string(long_text) + "b");
+        bench::do_not_optimize(o);
+        check("S o(std::string(..) + \"b\"): allocations beyond building the argument",
+              scope.allocations() - argument_allocations, 0);
+    }
+}
+
+} // namespace
+
+int main()
+{
+    check_create_example();
+    check_example_storage();
+    check_string_into_S();
+
+    if (g_failures)
+    {
+        std::fprintf(stderr, "%d of %d checks failed (%s)\n", g_failures, g_checks, mode);
+        return 1;
+    }
+    std::printf("all %d checks passed (%s)\n", g_checks, mode);
+    return 0;
+}
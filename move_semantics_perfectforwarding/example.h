@@ -0,0 +1,178 @@
+#pragma once
+
+// The `example` buffer class of move_semantics.cpp, allocator aware.
+//
+// The original does `new unsigned int[size]` in every constructor, copy
+// constructor and copy assignment, so creating and destroying millions
+// of them (or create_example(5000) in a loop) is a stream of malloc and
+// free calls. This version takes its memory from a
+// std::pmr::memory_resource instead, so the caller decides where the
+// buffers come from:
+//
+//   std::pmr::new_delete_resource()          same as before: new/delete
+//   std::pmr::unsynchronized_pool_resource   size class pools, blocks
+//                                            are reused after a free
+//   std::pmr::monotonic_buffer_resource      bump allocation, free is a
+//                                            no-op, everything is given
+//                                            back at once
+//
+// It is a proper allocator aware type (allocator_type plus the trailing
+// allocator constructor arguments), so a std::pmr::vector<example>
+// hands its own resource to every element it constructs:
+//
+//   std::pmr::monotonic_buffer_resource arena;
+//   std::pmr::vector<example> v(&arena);
+//   v.emplace_back(16);   // the vector and the buffer both in `arena`
+//
+// As with std::pmr containers, the allocator sticks to the object: a
+// move constructor takes the allocator along with the buffer, while
+// assignment keeps the target's allocator and can only steal the buffer
+// when both use the same resource (otherwise it copies).
+//
+// Compared to the original it also avoids allocations altogether where
+// it can:
+//
+// * Copy assignment reuses the existing buffer when it is big enough
+//   (like std::vector, the capacity is kept when the size shrinks)
+//   instead of delete[] + new[] on every assignment.
+// * Up to inline_capacity elements live inside the object itself (small
+//   buffer optimization), which with the rest of the members makes one
+//   64 byte cache line. Short arrays never touch the allocator.
+// * The move constructor is noexcept. std::vector only relocates its
+//   elements by move when that cannot throw; the original's move
+//   constructor is not marked noexcept, so every reallocation of a
+//   std::vector<example> deep copies all of them. (Move assignment may
+//   have to copy between different resources, so it cannot be noexcept.)
+
+#include <algorithm>
+#include <cstddef>
+#include <memory_resource>
+#include <utility>
+
+class example
+{
+  public:
+    using allocator_type = std::pmr::polymorphic_allocator<unsigned int>;
+
+    static constexpr std::size_t inline_capacity = 8;
+
+    explicit example(std::size_t size, const allocator_type& alloc = {}) : m_alloc(alloc)
+    {
+        reserve_uninitialized(size);
+    }
+
+    example(const example& other, const allocator_type& alloc = {}) : m_alloc(alloc)
+    {
+        reserve_uninitialized(other.m_size);
+        std::copy(other.m_data, other.m_data + other.m_size, m_data);
+    }
+
+    example(example&& other) noexcept : m_alloc(other.m_alloc) { steal(other); }
+
+    // Moves only when `alloc` is the allocator of `other`, copies otherwise.
+    example(example&& other, const allocator_type& alloc) : m_alloc(alloc)
+    {
+        if (m_alloc == other.m_alloc)
+            steal(other);
+        else
+        {
+            reserve_uninitialized(other.m_size);
+            std::copy(other.m_data, other.m_data + other.m_size, m_data);
+        }
+    }
+
+    example& operator=(const example& other)
+    {
+        if (this == &other)
+            return *this;
+        if (other.m_size <= m_capacity)
+        {
+            // fits: no allocation at all
+            std::copy(other.m_data, other.m_data + other.m_size, m_data);
+            m_size = other.m_size;
+            return *this;
+        }
+        // allocate before releasing, so a throwing allocation leaves *this intact
+        unsigned int* data = m_alloc.allocate(other.m_size);
+        std::copy(other.m_data, other.m_data + other.m_size, data);
+        release();
+        m_data = data;
+        m_size = other.m_size;
+        m_capacity = other.m_size;
+        return *this;
+    }
+
+    example& operator=(example&& other)
+    {
+        if (this == &other)
+            return *this;
+        if (m_alloc != other.m_alloc)
+            return *this = static_cast<const example&>(other);
+        release();
+        steal(other);
+        return *this;
+    }
+
+    ~example() { release(); }
+
+    std::size_t size() const { return m_size; }
+    std::size_t capacity() const { return m_capacity; }
+    bool is_inline() const { return m_data == m_inline; }
+    unsigned int* data() { return m_data; }
+    const unsigned int* data() const { return m_data; }
+    allocator_type get_allocator() const { return m_alloc; }
+
+  private:
+    // Room for `size` elements, left uninitialized like new unsigned int[size].
+    // Only called on an empty (inline) object.
+    void reserve_uninitialized(std::size_t size)
+    {
+        if (size > inline_capacity)
+        {
+            m_data = m_alloc.allocate(size);
+            m_capacity = size;
+        }
+        m_size = size;
+    }
+
+    // Takes over the contents of `other` (same allocator) and leaves it empty.
+    void steal(example& other) noexcept
+    {
+        if (other.is_inline())
+            // (the min only tells the compiler what is_inline() implies)
+            std::copy_n(other.m_inline, std::min(other.m_size, inline_capacity), m_inline);
+        else
+        {
+            m_data = other.m_data;
+            m_capacity = other.m_capacity;
+        }
+        m_size = other.m_size;
+        other.m_data = other.m_inline;
+        other.m_size = 0;
+        other.m_capacity = inline_capacity;
+    }
+
+    // Back to empty and inline.
+    void release()
+    {
+        if (!is_inline())
+            m_alloc.deallocate(m_data, m_capacity);
+        m_data = m_inline;
+        m_size = 0;
+        m_capacity = inline_capacity;
+    }
+
+    allocator_type m_alloc;
+    unsigned int* m_data = m_inline;
+    std::size_t m_size = 0;
+    std::size_t m_capacity = inline_capacity;
+    unsigned int m_inline[inline_capacity];
+};
+
+static_assert(sizeof(example) == 64 || sizeof(void*) != 8, "example is meant to fill one cache line");
+
+// create_example of move_semantics.cpp, with the memory resource to use.
+inline example create_example(std::size_t size, const example::allocator_type& alloc = {})
+{
+    return example(size, alloc);
+}
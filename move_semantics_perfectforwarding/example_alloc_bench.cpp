@@ -0,0 +1,129 @@
+// Benchmark for where the buffers of move_semantics.cpp's `example`
+// come from: new[]/delete[] per object (the original class) against
+// the allocator aware example.h on the std::pmr memory resources.
+//
+// create_destroy  millions of small buffers created into a vector and
+//                 destroyed again, e.g. per frame or per request
+// mixed_sizes     the same with random sizes, destroyed in random order,
+//                 which is where a general purpose heap fragments
+// churn           obj6 = create_example(5000) in a loop, as in main()
+//
+// The monotonic arena is left out of `churn`: it never reuses memory,
+// so a loop that frees as much as it allocates would grow it forever.
+//
+// --size=N  elements per buffer in create_destroy (default 16)
+
+#include "bench.h"
+#include "example.h"
+#include "example_before.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <memory_resource>
+#include <random>
+#include <utility>
+#include <vector>
+
+BENCH_NOINLINE before::example create_before_example(std::size_t size)
+{
+    return before::create_example(size);
+}
+
+BENCH_NOINLINE example create_pmr_example(std::size_t size, const example::allocator_type& alloc)
+{
+    return create_example(size, alloc);
+}
+
+// Fill `v` with one buffer per size, then destroy them in the order
+// `order` scrambles them into (the identity keeps creation order).
+template <typename Vector>
+void create_then_destroy(Vector& v, const std::vector<std::size_t>& sizes,
+                         const std::vector<std::size_t>& order)
+{
+    v.reserve(sizes.size());
+    for (std::size_t i = 0; i < sizes.size(); ++i)
+    {
+        v.emplace_back(sizes[i]);
+        v.back().data()[0] = static_cast<unsigned int>(i);
+    }
+    bench::do_not_optimize(v.data());
+    // swapping only moves the pointers around, so clear() then frees
+    // the buffers in an order unrelated to their addresses
+    for (std::size_t i = 0; i < order.size(); ++i)
+        if (order[i] != i)
+            std::swap(v[i], v[order[i]]);
+    v.clear();
+}
+
+int main(int argc, char** argv)
+{
+    bench::runner r("example_alloc", argc, argv);
+
+    const std::size_t count = r.size<std::size_t>(1000000, 10000);
+    const auto size = static_cast<std::size_t>(r.param("size", 16));
+
+    std::vector<std::size_t> fixed_sizes(count, size);
+    std::vector<std::size_t> in_order(count);
+    for (std::size_t i = 0; i < count; ++i)
+        in_order[i] = i;
+
+    std::mt19937 rng(42);
+    std::uniform_int_distribution<std::size_t> size_of(1, 256);
+    std::vector<std::size_t> random_sizes(count);
+    for (auto& s : random_sizes)
+        s = size_of(rng);
+    std::vector<std::size_t> shuffled = in_order;
+    std::shuffle(shuffled.begin(), shuffled.end(), rng);
+
+    // one group per workload, the original new[]/delete[] class first
+    auto workload = [&](const char* group, const std::vector<std::size_t>& sizes,
+                        const std::vector<std::size_t>& order) {
+        r.run(group, "new[]/delete[]", count, [&] {
+            std::vector<before::example> v;
+            create_then_destroy(v, sizes, order);
+        });
+        r.run(group, "pmr_new_delete", count, [&] {
+            std::pmr::vector<example> v(std::pmr::new_delete_resource());
+            create_then_destroy(v, sizes, order);
+        });
+        r.run(group, "pmr_pool", count, [&] {
+            std::pmr::unsynchronized_pool_resource pool;
+            std::pmr::vector<example> v(&pool);
+            create_then_destroy(v, sizes, order);
+        });
+        r.run(group, "pmr_monotonic", count, [&] {
+            std::pmr::monotonic_buffer_resource arena;
+            std::pmr::vector<example> v(&arena);
+            create_then_destroy(v, sizes, order);
+        });
+    };
+    workload("create_destroy", fixed_sizes, in_order);
+    workload("mixed_sizes", random_sizes, shuffled);
+
+    const std::size_t loops = r.size<std::size_t>(1000000, 10000);
+    r.run("churn", "new[]/delete[]", loops, [&] {
+        before::example obj6(5000);
+        for (std::size_t i = 0; i < loops; ++i)
+        {
+            obj6 = create_before_example(5000);
+            obj6.data()[0] = static_cast<unsigned int>(i);
+        }
+        bench::do_not_optimize(obj6.data()[0]);
+    });
+    r.run("churn", "pmr_pool", loops, [&] {
+        // 20 KB is above the default largest pooled block of libstdc++,
+        // and oversized requests go upstream with extra bookkeeping
+        std::pmr::pool_options options;
+        options.largest_required_pool_block = 5000 * sizeof(unsigned int);
+        std::pmr::unsynchronized_pool_resource pool(options);
+        example obj6(5000, &pool);
+        for (std::size_t i = 0; i < loops; ++i)
+        {
+            obj6 = create_pmr_example(5000, &pool);
+            obj6.data()[0] = static_cast<unsigned int>(i);
+        }
+        bench::do_not_optimize(obj6.data()[0]);
+    });
+
+    return r.finish();
+}
@@ -0,0 +1,67 @@
+#pragma once
+
+// The `example` class of move_semantics.cpp as it is there: new[] and
+// delete[] for every buffer, a reallocation on every copy assignment
+// and a move constructor that is not noexcept. The "before" of the
+// example benchmarks; example.h is the "after".
+
+#include <algorithm>
+#include <cstddef>
+
+namespace before {
+
+class example
+{
+  public:
+    explicit example(std::size_t size) : m_data(new unsigned int[size]), m_size(size) {}
+
+    example(const example& other) : m_data(new unsigned int[other.m_size]), m_size(other.m_size)
+    {
+        std::copy(other.m_data, other.m_data + other.m_size, m_data);
+    }
+
+    example& operator=(const example& other)
+    {
+        if (this == &other)
+            return *this;
+        delete[] m_data;
+        m_data = new unsigned int[other.m_size];
+        std::copy(other.m_data, other.m_data + other.m_size, m_data);
+        m_size = other.m_size;
+        return *this;
+    }
+
+    example(example&& other) : m_data(other.m_data), m_size(other.m_size)
+    {
+        other.m_data = nullptr;
+        other.m_size = 0;
+    }
+
+    example& operator=(example&& other)
+    {
+        if (this == &other)
+            return *this;
+        delete[] m_data;
+        m_data = other.m_data;
+        m_size = other.m_size;
+        other.m_data = nullptr;
+        other.m_size = 0;
+        return *this;
+    }
+
+    ~example() { delete[] m_data; }
+
+    std::size_t size() const { return m_size; }
+    unsigned int* data() { return m_data; }
+
+  private:
+    unsigned int* m_data;
+    std::size_t m_size;
+};
+
+inline example create_example(std::size_t size)
+{
+    return example(size);
+}
+
+} // namespace before
@@ -0,0 +1,113 @@
+// Benchmark for the copy/move behaviour of `example`: the original
+// class of move_semantics.cpp (example_before.h) against example.h.
+//
+// growth_small  push_back of 4 element buffers into a std::vector
+//               without reserve(). Before: one new[] per buffer, and
+//               every reallocation copies all buffers again because the
+//               move constructor is not noexcept. After: inline storage,
+//               relocation by (noexcept) move.
+// growth        the same with 64 element buffers, which do not fit
+//               inline: only the noexcept move is left to make the
+//               difference.
+// reassign      a[i] = b[i] over and over on equally sized buffers.
+//               Before: delete[] + new[] per assignment. After: the
+//               existing buffer is reused.
+
+#include "bench.h"
+#include "example.h"
+#include "example_before.h"
+
+#include <cstddef>
+#include <cstdio>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+template <typename Example>
+void grow(std::size_t count, std::size_t size)
+{
+    std::vector<Example> v;
+    for (std::size_t i = 0; i < count; ++i)
+    {
+        Example e(size);
+        e.data()[0] = static_cast<unsigned int>(i);
+        v.push_back(e);   // a copy, as from an existing object
+    }
+    bench::do_not_optimize(v.data());
+}
+
+template <typename Example>
+std::vector<Example> filled(std::size_t count, std::size_t size, unsigned int seed)
+{
+    std::vector<Example> v;
+    v.reserve(count);
+    for (std::size_t i = 0; i < count; ++i)
+    {
+        v.emplace_back(size);
+        for (std::size_t k = 0; k < size; ++k)
+            v.back().data()[k] = static_cast<unsigned int>(seed + i + k);
+    }
+    return v;
+}
+
+template <typename Example>
+void reassign(std::vector<Example>& a, const std::vector<Example>& b, std::size_t rounds)
+{
+    for (std::size_t round = 0; round < rounds; ++round)
+    {
+        for (std::size_t i = 0; i < a.size(); ++i)
+            a[i] = b[i];
+        bench::clobber_memory();
+    }
+}
+
+// What the numbers above rely on.
+bool behaves()
+{
+    const auto b = filled<example>(1, 64, 1);
+    auto a = filled<example>(1, 64, 0);
+    const unsigned int* buffer = a[0].data();
+    a[0] = b[0];
+    if (a[0].data() != buffer || a[0].size() != 64 || a[0].data()[63] != b[0].data()[63])
+        return false;   // copy assignment did not reuse the buffer
+
+    example small(4);
+    small.data()[3] = 7;
+    const example moved(std::move(small));
+    if (!moved.is_inline() || moved.data()[3] != 7 || small.size() != 0)
+        return false;
+
+    example big(64);
+    buffer = big.data();
+    const example stolen(std::move(big));
+    return stolen.data() == buffer && big.size() == 0 && std::is_nothrow_move_constructible_v<example>;
+}
+
+int main(int argc, char** argv)
+{
+    bench::runner r("example_copy", argc, argv);
+
+    // no numbers at all for an example that does not do what they measure
+    if (!behaves())
+    {
+        std::fprintf(stderr, "example does not behave as documented\n");
+        return 1;
+    }
+
+    const std::size_t count = r.size<std::size_t>(1000000, 10000);
+    r.run("growth_small", "before", count, [&] { grow<before::example>(count, 4); });
+    r.run("growth_small", "after", count, [&] { grow<example>(count, 4); });
+    r.run("growth", "before", count, [&] { grow<before::example>(count, 64); });
+    r.run("growth", "after", count, [&] { grow<example>(count, 64); });
+
+    const std::size_t objects = 10000;
+    const std::size_t rounds = r.size<std::size_t>(100, 2);
+    auto a_before = filled<before::example>(objects, 64, 0);
+    const auto b_before = filled<before::example>(objects, 64, 1);
+    auto a_after = filled<example>(objects, 64, 0);
+    const auto b_after = filled<example>(objects, 64, 1);
+    r.run("reassign", "before", objects * rounds, [&] { reassign(a_before, b_before, rounds); });
+    r.run("reassign", "after", objects * rounds, [&] { reassign(a_after, b_after, rounds); });
+
+    return r.finish();
+}
@@ -191,5 +191,12 @@ int main()
 }
 
 
+// Bulk creation of these buffers (millions of them, or create_example
+// in a loop) is mostly malloc/free. example.h is the same class taking
+// its memory from a std::pmr::memory_resource (pool or arena), and
+// example_alloc_bench.cpp measures the difference. example.h also keeps
+// short arrays inline, reuses its buffer on copy assignment and has a
+// noexcept move constructor (example_copy_bench.cpp).
+
 // References:
 // https://www.internalpointers.com/post/c-rvalue-references-and-move-semantics-beginners
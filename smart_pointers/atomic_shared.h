@@ -0,0 +1,193 @@
+#pragma once
+
+// A lock free atomic shared pointer for the "published config" pattern:
+// a writer now and then replaces the current value, many readers keep
+// loading it, and each reader's copy stays valid for as long as it is
+// held, however many times the writer replaces it meanwhile.
+//
+// shared_pointer.cpp's notes: one shared_ptr object is not safe to use
+// from two threads at once. The usual fixes are a mutex around it (every
+// load serializes on the lock) or std::atomic<std::shared_ptr<T>>, which
+// libstdc++ implements with a lock bit inside the pointer (readers still
+// exclude each other for the duration of a load). Neither lets readers
+// run in parallel.
+//
+// This one uses split reference counting (C++ Concurrency in Action,
+// 7.2.4). The 64 bit atomic word holds the node pointer in its low 48
+// bits and an "external" count in the high 16:
+//
+//   load:  1. fetch_add one external count: reads the pointer and
+//             protects the node in one atomic step
+//          2. increment the node's own ("internal") count: the reader's
+//             reference
+//          3. give the external count back with a CAS, if the word still
+//             holds the same node; if the writer has replaced it in the
+//             meantime, the writer moves all external counts into the
+//             internal count, so drop one internal count instead
+//   store: exchange the word, then fold the old node's external count
+//          into its internal count
+//
+// The readers' decrements of step 3 and the writer's fold race: any
+// number of readers may drop their count (and their reference, too)
+// before the writer has added what it owes them. So while a node is
+// published its internal count is biased by -published, far below
+// anything the readers can take it to, and the fold adds the bias back
+// with the external counts. Until then the count is negative and never
+// zero; from then on it is the number of references, and whichever
+// decrement or fold brings it to exactly zero deletes the node.
+//
+// Every operation is a handful of atomic instructions and none blocks:
+// no thread ever holds anything another one has to wait for. That is
+// lock free, not wait free: the CAS of step 3 retries while other readers
+// change the external count, so under contention a load may loop a few
+// times (the system as a whole always makes progress). Readers do still
+// write to the shared word, so its cache line moves between the reading
+// cores (unlike hazard pointers or RCU, where a read touches only thread
+// local data).
+//
+// Needs user space pointers that fit in 48 bits, as on x86-64 and
+// AArch64 Linux with the default 4 level page tables.
+
+#include <atomic>
+#include <cstdint>
+#include <utility>
+
+// Called between the steps above. atomic_shared_check.cpp defines it to
+// yield now and then, so that the other threads run in the windows.
+#ifndef ATOMIC_SHARED_BETWEEN_STEPS
+#define ATOMIC_SHARED_BETWEEN_STEPS()
+#endif
+
+template <typename T>
+class atomic_shared
+{
+    struct node
+    {
+        template <typename... Args>
+        explicit node(Args&&... args) : value(std::forward<Args>(args)...)
+        {
+        }
+        std::atomic<std::int64_t> refs{-published};
+        T value;
+    };
+
+    // Out of line: freeing is the rare case, and load() is smaller
+    // without it. (Inlined, it also has GCC's -Wuse-after-free warn
+    // about load(), whose decrement never frees: it still holds the
+    // reader's own reference.)
+    [[gnu::noinline]] static void destroy(node* n) noexcept { delete n; }
+
+    static void release(node* n) noexcept
+    {
+        if (n && n->refs.fetch_sub(1, std::memory_order_acq_rel) == 1)
+            destroy(n);
+    }
+
+    // The atomic lets go of the node it held: the readers' external
+    // counts come in, the bias goes.
+    static void fold(std::uint64_t word) noexcept
+    {
+        node* const n = pointer(word);
+        if (!n)
+            return;
+        const std::int64_t count = static_cast<std::int64_t>(word >> pointer_bits) + published;
+        if (n->refs.fetch_add(count, std::memory_order_acq_rel) == -count)
+            destroy(n);
+    }
+
+  public:
+    // A reader's reference to one published value. Copyable; the value
+    // lives until the last reference to it (or the atomic) lets go.
+    class reference
+    {
+      public:
+        reference() noexcept = default;
+        reference(const reference& other) noexcept : m_node(other.m_node)
+        {
+            if (m_node)
+                m_node->refs.fetch_add(1, std::memory_order_relaxed);
+        }
+        reference(reference&& other) noexcept : m_node(std::exchange(other.m_node, nullptr)) {}
+        reference& operator=(reference other) noexcept
+        {
+            std::swap(m_node, other.m_node);
+            return *this;
+        }
+        ~reference() { release(m_node); }
+
+        const T* get() const noexcept { return m_node ? &m_node->value : nullptr; }
+        const T& operator*() const noexcept { return m_node->value; }
+        const T* operator->() const noexcept { return &m_node->value; }
+        explicit operator bool() const noexcept { return m_node != nullptr; }
+
+      private:
+        friend class atomic_shared;
+        explicit reference(node* n) noexcept : m_node(n) {}
+        node* m_node = nullptr;
+    };
+
+    atomic_shared() noexcept = default;
+
+    template <typename... Args>
+    explicit atomic_shared(std::in_place_t, Args&&... args) : m_word(pack(new node(std::forward<Args>(args)...), 0))
+    {
+    }
+
+    atomic_shared(const atomic_shared&) = delete;
+    atomic_shared& operator=(const atomic_shared&) = delete;
+
+    ~atomic_shared() { fold(m_word.load(std::memory_order_acquire)); }
+
+    reference load() const noexcept
+    {
+        // 1. protect whatever node is current
+        std::uint64_t word = m_word.fetch_add(one_external, std::memory_order_acquire);
+        node* const n = pointer(word);
+        ATOMIC_SHARED_BETWEEN_STEPS();
+        // 2. the reader's own reference
+        if (n)
+            n->refs.fetch_add(1, std::memory_order_relaxed);
+        ATOMIC_SHARED_BETWEEN_STEPS();
+        // 3. give the external count back
+        word += one_external;
+        for (;;)
+        {
+            if (pointer(word) != n)
+            {
+                // replaced: our external count becomes an internal one
+                release(n);
+                break;
+            }
+            if (m_word.compare_exchange_weak(word, word - one_external, std::memory_order_release,
+                                             std::memory_order_relaxed))
+                break;
+        }
+        return reference(n);
+    }
+
+    // Publishes a new value; readers holding the old one keep it.
+    template <typename... Args>
+    void emplace(Args&&... args)
+    {
+        node* const fresh = new node(std::forward<Args>(args)...);
+        const std::uint64_t old = m_word.exchange(pack(fresh, 0), std::memory_order_acq_rel);
+        ATOMIC_SHARED_BETWEEN_STEPS();
+        fold(old);
+    }
+
+  private:
+    static constexpr unsigned pointer_bits = 48;
+    static constexpr std::uint64_t pointer_mask = (std::uint64_t(1) << pointer_bits) - 1;
+    static constexpr std::uint64_t one_external = std::uint64_t(1) << pointer_bits;
+    static_assert(sizeof(void*) == 8, "atomic_shared packs a 48 bit pointer into 64 bits");
+    // More than references to one node can ever be held at once.
+    static constexpr std::int64_t published = std::int64_t(1) << 48;
+
+    static std::uint64_t pack(node* n, std::uint64_t external)
+    {
+        return reinterpret_cast<std::uintptr_t>(n) | (external << pointer_bits);
+    }
+    static node* pointer(std::uint64_t word) { return reinterpret_cast<node*>(word & pointer_mask); }
+
+    mutable std::atomic<std::uint64_t> m_word{0};
+};
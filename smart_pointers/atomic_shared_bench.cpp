@@ -0,0 +1,146 @@
+// One writer publishing a new `A` (shared_pointer.cpp) while readers
+// keep loading the current one, three ways:
+//
+//   mutex_shared_ptr       std::shared_ptr<const A> behind a std::mutex
+//   std_atomic_shared_ptr  std::atomic<std::shared_ptr<const A>> (C++20)
+//   atomic_shared          split reference counting (atomic_shared.h)
+//
+// read_mostly  the writer publishes every 100 us, like a config reload
+// write_heavy  the writer publishes as fast as it can
+//
+// ns/item is wall time per load over all readers together, i.e. the
+// inverse of the read throughput. Every reader checks that what it
+// loaded is a consistent A. --readers=N (default: the CPUs but one,
+// at least one) and --loads=N per reader.
+
+#include "atomic_shared.h"
+#include "bench.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+struct A
+{
+    int M;
+    int twice;   // always 2 * M: a torn or freed A shows up
+    A(int m) : M(m), twice(2 * m) {}
+};
+
+class mutex_shared_ptr
+{
+  public:
+    std::shared_ptr<const A> load() const
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return m_ptr;
+    }
+    void publish(int m)
+    {
+        auto fresh = std::make_shared<const A>(m);
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_ptr.swap(fresh);   // the old one is freed outside the lock
+    }
+
+  private:
+    mutable std::mutex m_mutex;
+    std::shared_ptr<const A> m_ptr = std::make_shared<const A>(0);
+};
+
+class std_atomic_shared_ptr
+{
+  public:
+    std::shared_ptr<const A> load() const { return m_ptr.load(std::memory_order_acquire); }
+    void publish(int m) { m_ptr.store(std::make_shared<const A>(m), std::memory_order_release); }
+
+  private:
+    std::atomic<std::shared_ptr<const A>> m_ptr{std::make_shared<const A>(0)};
+};
+
+class split_count_ptr
+{
+  public:
+    atomic_shared<A>::reference load() const { return m_ptr.load(); }
+    void publish(int m) { m_ptr.emplace(m); }
+
+  private:
+    atomic_shared<A> m_ptr{std::in_place, 0};
+};
+
+std::atomic<bool> g_inconsistent{false};
+
+// `readers` threads doing `loads` loads each, one writer publishing
+// (pausing `pause` between publications) until they are done.
+template <typename Published>
+void read_while_publishing(unsigned readers, long loads, std::chrono::microseconds pause)
+{
+    Published published;
+    std::atomic<unsigned> running{readers};
+    std::thread writer([&] {
+        int m = 1;
+        while (running.load(std::memory_order_relaxed) != 0)
+        {
+            published.publish(m++);
+            if (pause.count())
+                std::this_thread::sleep_for(pause);
+        }
+    });
+    std::vector<std::thread> threads;
+    for (unsigned t = 0; t < readers; ++t)
+        threads.emplace_back([&] {
+            long sum = 0;
+            bool consistent = true;
+            for (long i = 0; i < loads; ++i)
+            {
+                const auto a = published.load();
+                consistent &= a->twice == 2 * a->M;
+                sum += a->M;
+            }
+            bench::do_not_optimize(sum);
+            if (!consistent)
+                g_inconsistent = true;
+            running.fetch_sub(1, std::memory_order_relaxed);
+        });
+    for (auto& t : threads)
+        t.join();
+    writer.join();
+}
+
+int main(int argc, char** argv)
+{
+    bench::runner r("atomic_shared", argc, argv);
+
+    const auto cpus = static_cast<long>(std::max(1u, std::thread::hardware_concurrency()));
+    const auto readers = static_cast<unsigned>(std::max(1L, r.param("readers", cpus - 1)));
+    const long loads = r.param("loads", r.size(1000000L, 10000L));
+    const auto items = static_cast<std::size_t>(readers * loads);
+
+    struct workload
+    {
+        const char* group;
+        std::chrono::microseconds pause;
+    };
+    for (const auto& w : {workload{"read_mostly", std::chrono::microseconds(100)},
+                          workload{"write_heavy", std::chrono::microseconds(0)}})
+    {
+        r.run(w.group, "mutex_shared_ptr", items,
+              [&] { read_while_publishing<mutex_shared_ptr>(readers, loads, w.pause); });
+        r.run(w.group, "std_atomic_shared_ptr", items,
+              [&] { read_while_publishing<std_atomic_shared_ptr>(readers, loads, w.pause); });
+        r.run(w.group, "atomic_shared", items,
+              [&] { read_while_publishing<split_count_ptr>(readers, loads, w.pause); });
+    }
+
+    if (g_inconsistent)
+    {
+        std::fprintf(stderr, "a reader loaded an inconsistent A\n");
+        return 1;
+    }
+
+    return r.finish();
+}
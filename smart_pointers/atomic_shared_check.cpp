@@ -0,0 +1,136 @@
+// atomic_shared.h under contention: several writers publishing while
+// several readers load, keep a few of the values they loaded for a
+// while, copy them and let them go in any order. Every value is
+// checked when it is read, a destroyed one is poisoned so that reading
+// it after the free shows, and once everything is joined every value
+// ever published must have been destroyed exactly once. Runs as part of
+// the build; any difference fails it.
+//
+// Between the steps of a load or a publication every thread yields now
+// and then, so that the races the split counts have to survive happen
+// even on a machine with few cores: a reader stopped between taking the
+// external count and its reference, writers replacing the value while
+// readers are in between, readers dropping their counts before the
+// writer has folded them in.
+
+#include <thread>
+
+namespace {
+
+void between_steps()
+{
+    thread_local unsigned calls = 0;
+    if (++calls % 3 == 0)
+        std::this_thread::yield();
+}
+
+} // namespace
+
+#define ATOMIC_SHARED_BETWEEN_STEPS() between_steps()
+#include "atomic_shared.h"
+
+#include <array>
+#include <atomic>
+#include <cstdio>
+#include <vector>
+
+namespace {
+
+constexpr int readers = 4;
+constexpr int writers = 3;
+constexpr int loads_per_reader = 200000;
+constexpr int publications_per_writer = 20000;
+
+std::atomic<long> g_constructed{0};
+std::atomic<long> g_destroyed{0};
+std::atomic<long> g_bad_reads{0};
+
+struct payload
+{
+    explicit payload(long v) : value(v), inverse(~v) { g_constructed.fetch_add(1, std::memory_order_relaxed); }
+    payload(const payload&) = delete;
+    payload& operator=(const payload&) = delete;
+    ~payload()
+    {
+        if (inverse != ~value)
+            g_bad_reads.fetch_add(1, std::memory_order_relaxed);   // destroyed twice
+        inverse = value;   // poisoned
+        g_destroyed.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    // volatile: re-read from memory on every check
+    volatile long value;
+    volatile long inverse;
+};
+
+void read(const payload& p)
+{
+    if (p.inverse != ~p.value)
+        g_bad_reads.fetch_add(1, std::memory_order_relaxed);
+}
+
+int g_checks = 0;
+int g_failures = 0;
+
+void check(const char* what, long actual, long expected)
+{
+    ++g_checks;
+    if (actual == expected)
+        return;
+    ++g_failures;
+    std::fprintf(stderr, "FAILED: %s: %ld, expected %ld\n", what, actual, expected);
+}
+
+} // namespace
+
+int main()
+{
+    {
+        atomic_shared<payload> current(std::in_place, 0);
+        std::atomic<int> ready{0};
+        std::vector<std::thread> threads;
+        for (int r = 0; r < readers; ++r)
+            threads.emplace_back([&, r] {
+                ready.fetch_add(1);
+                while (ready.load() < readers + writers)
+                    std::this_thread::yield();
+                // held across publications, let go out of order
+                std::array<atomic_shared<payload>::reference, 5> held;
+                for (int i = 0; i < loads_per_reader; ++i)
+                {
+                    auto loaded = current.load();
+                    read(*loaded);
+                    held[(i * 3 + r) % held.size()] = loaded;
+                    if (i % 7 == 0)
+                        held[i % held.size()] = atomic_shared<payload>::reference();
+                    for (const auto& h : held)
+                        if (h)
+                            read(*h);
+                }
+            });
+        for (int w = 0; w < writers; ++w)
+            threads.emplace_back([&, w] {
+                ready.fetch_add(1);
+                while (ready.load() < readers + writers)
+                    std::this_thread::yield();
+                for (long i = 1; i <= publications_per_writer; ++i)
+                {
+                    current.emplace(w * publications_per_writer + i);
+                    if (i % 64 == 0)
+                        std::this_thread::yield();
+                }
+            });
+        for (auto& t : threads)
+            t.join();
+        read(*current.load());
+    }
+
+    check("values read after being freed or torn", g_bad_reads.load(), 0);
+    check("values published", g_constructed.load(), 1 + writers * publications_per_writer);
+    check("values destroyed", g_destroyed.load(), g_constructed.load());
+
+    if (g_failures)
+        return 1;
+    std::printf("atomic_shared_check: %d checks passed\n", g_checks);
+    return 0;
+}
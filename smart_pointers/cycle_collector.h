@@ -0,0 +1,312 @@
+#pragma once
+
+// A debugging aid for the leak of shared_pointer_cyclic_problem.cpp:
+// objects that are only kept alive by shared_ptr cycles among
+// themselves (Lucy <-> Ricky after partnerUp, or a Resource owning
+// itself). weak_pointer.cpp fixes the design by hand; in a big object
+// graph the hard part is finding out that, and where, it is needed.
+//
+// Register the shared objects with a cycle_registry. A type takes part
+// by listing its owning edges (and, to let the registry break cycles,
+// by being able to drop them):
+//
+//   class Person {
+//       std::shared_ptr<Person> m_partner;
+//     public:
+//       template <typename Visit>
+//       void for_each_shared_edge(Visit&& visit) const { visit(m_partner); }
+//       void break_shared_edges() { m_partner.reset(); }
+//   };
+//
+//   cycle_registry registry;
+//   registry.add(lucy);  registry.add(ricky);
+//   ...                                  // lucy and ricky go away
+//   registry.scan().leaked               // 2, in one cycle of 2
+//   registry.collect()                   // breaks it, both destroyed
+//
+// scan() works like the cycle detector of a reference counting garbage
+// collector (CPython's, for one): start from every object's use_count,
+// subtract one for every shared edge coming from another registered
+// object, and what is left over are the references from outside the
+// registry (locals, globals, containers). Everything reachable from
+// objects with outside references is alive; the rest is leaked, and its
+// strongly connected components are the cycles responsible.
+//
+// The registry only holds weak_ptrs and never copies a shared_ptr while
+// counting, so it does not change what it measures. It is meant for a
+// single thread (or a quiescent program): debug builds, tests, a
+// "check for leaks" command. register_for_cycle_check() adds to a
+// process wide registry and compiles to nothing under NDEBUG.
+
+#include <algorithm>
+#include <cstddef>
+#include <memory>
+#include <utility>
+#include <vector>
+
+class cycle_registry
+{
+  public:
+    struct report
+    {
+        std::size_t live = 0;     // registered objects still alive
+        std::size_t leaked = 0;   // alive, but unreachable from outside the registry
+        // the cycles among the leaked objects, one strongly connected
+        // component (a cycle or a knot of cycles) per entry; leaked
+        // objects merely owned by a cycle are not listed
+        std::vector<std::vector<const void*>> cycles;
+    };
+
+    template <typename T>
+    void add(const std::shared_ptr<T>& object)
+    {
+        if (!object)
+            return;
+        m_entries.push_back({std::weak_ptr<const void>(object), object.get(), &visit_edges<T>, &break_edges<T>});
+    }
+
+    // Registered entries, including objects that have died since.
+    std::size_t size() const { return m_entries.size(); }
+
+    // Forgets the objects that have died.
+    void prune()
+    {
+        m_entries.erase(std::remove_if(m_entries.begin(), m_entries.end(),
+                                       [](const entry& e) { return e.ref.expired(); }),
+                        m_entries.end());
+    }
+
+    report scan()
+    {
+        prune();
+        build_graph();
+        const std::size_t n = m_entries.size();
+
+        // references from outside the registry
+        std::vector<long> outside(n);
+        for (std::size_t i = 0; i < n; ++i)
+            outside[i] = m_entries[i].ref.use_count();
+        for (std::size_t target : m_targets)
+            --outside[target];
+
+        // alive: reachable from an object with outside references
+        std::vector<char> reachable(n, 0);
+        std::vector<std::size_t> stack;
+        for (std::size_t i = 0; i < n; ++i)
+            if (outside[i] > 0 && !reachable[i])
+            {
+                reachable[i] = 1;
+                stack.push_back(i);
+                while (!stack.empty())
+                {
+                    const std::size_t v = stack.back();
+                    stack.pop_back();
+                    for (std::size_t k = m_first_edge[v]; k < m_first_edge[v + 1]; ++k)
+                        if (!reachable[m_targets[k]])
+                        {
+                            reachable[m_targets[k]] = 1;
+                            stack.push_back(m_targets[k]);
+                        }
+                }
+            }
+
+        report result;
+        result.live = n;
+        m_leaked.clear();
+        for (std::size_t i = 0; i < n; ++i)
+            if (!reachable[i])
+                m_leaked.push_back(i);
+        result.leaked = m_leaked.size();
+        result.cycles = components(reachable);
+        return result;
+    }
+
+    // scan(), then breaks every leaked object's shared edges so that the
+    // cycles fall apart. Returns the number of objects that were leaked.
+    std::size_t collect()
+    {
+        const std::size_t leaked = scan().leaked;
+        // keep all of them alive until every edge is broken: breaking one
+        // may otherwise destroy another before its turn
+        std::vector<std::shared_ptr<const void>> pinned;
+        pinned.reserve(leaked);
+        for (std::size_t i : m_leaked)
+            if (auto object = m_entries[i].ref.lock())
+                pinned.push_back(std::move(object));
+        for (std::size_t i : m_leaked)
+            m_entries[i].break_edges(m_entries[i].object);
+        pinned.clear();
+        prune();
+        return leaked;
+    }
+
+  private:
+    class edge_visitor;
+    // entry index by control block, sorted with owner_before
+    using index_entry = std::pair<std::weak_ptr<const void>, std::size_t>;
+    using visit_fn = void (*)(const void* object, edge_visitor& visit);
+    using break_fn = void (*)(const void* object);
+
+    struct entry
+    {
+        std::weak_ptr<const void> ref;
+        const void* object;
+        visit_fn visit_edges;
+        break_fn break_edges;
+    };
+
+    // Receives the shared edges of one object and records the ones that
+    // point to registered objects (looked up by control block, so a
+    // shared_ptr<Base> to a registered Derived is found as well).
+    class edge_visitor
+    {
+      public:
+        edge_visitor(const std::vector<index_entry>& index, std::vector<std::size_t>& targets)
+            : m_index(index), m_targets(targets)
+        {
+        }
+
+        template <typename U>
+        void operator()(const std::shared_ptr<U>& edge)
+        {
+            if (!edge)
+                return;
+            // compares control blocks, no copy: use_count stays put
+            const auto it = std::lower_bound(m_index.begin(), m_index.end(), edge,
+                                             [](const index_entry& e, const std::shared_ptr<U>& p) {
+                                                 return e.first.owner_before(p);
+                                             });
+            if (it != m_index.end() && !edge.owner_before(it->first))
+                m_targets.push_back(it->second);
+        }
+
+      private:
+        const std::vector<index_entry>& m_index;
+        std::vector<std::size_t>& m_targets;
+    };
+
+    template <typename T>
+    static void visit_edges(const void* object, edge_visitor& visit)
+    {
+        static_cast<const T*>(object)->for_each_shared_edge(visit);
+    }
+
+    template <typename T>
+    static void break_edges(const void* object)
+    {
+        const_cast<T*>(static_cast<const T*>(object))->break_shared_edges();
+    }
+
+    // Edges between live registered objects, as adjacency lists:
+    // targets of entry i are m_targets[m_first_edge[i] .. m_first_edge[i + 1]).
+    void build_graph()
+    {
+        std::vector<index_entry> index;
+        index.reserve(m_entries.size());
+        for (std::size_t i = 0; i < m_entries.size(); ++i)
+            index.emplace_back(m_entries[i].ref, i);
+        std::sort(index.begin(), index.end(),
+                  [](const index_entry& a, const index_entry& b) { return a.first.owner_before(b.first); });
+
+        m_first_edge.assign(1, 0);
+        m_targets.clear();
+        edge_visitor visitor(index, m_targets);
+        for (const auto& e : m_entries)
+        {
+            e.visit_edges(e.object, visitor);
+            m_first_edge.push_back(m_targets.size());
+        }
+    }
+
+    // Strongly connected components among the leaked objects (Tarjan,
+    // iterative so that long chains do not overflow the stack).
+    bool points_to_itself(std::size_t v) const
+    {
+        for (std::size_t k = m_first_edge[v]; k < m_first_edge[v + 1]; ++k)
+            if (m_targets[k] == v)
+                return true;
+        return false;
+    }
+
+    std::vector<std::vector<const void*>> components(const std::vector<char>& reachable) const
+    {
+        const std::size_t n = m_entries.size();
+        const std::size_t unvisited = static_cast<std::size_t>(-1);
+        std::vector<std::size_t> order(n, unvisited), low(n, 0);
+        std::vector<char> on_stack(n, 0);
+        std::vector<std::size_t> stack;
+        std::vector<std::pair<std::size_t, std::size_t>> calls;   // node, next edge
+        std::vector<std::vector<const void*>> result;
+        std::size_t counter = 0;
+
+        for (std::size_t root : m_leaked)
+        {
+            if (order[root] != unvisited)
+                continue;
+            calls.push_back({root, m_first_edge[root]});
+            order[root] = low[root] = counter++;
+            stack.push_back(root);
+            on_stack[root] = 1;
+            while (!calls.empty())
+            {
+                auto& [v, k] = calls.back();
+                if (k < m_first_edge[v + 1])
+                {
+                    const std::size_t w = m_targets[k++];
+                    if (reachable[w])
+                        continue;
+                    if (order[w] == unvisited)
+                    {
+                        order[w] = low[w] = counter++;
+                        stack.push_back(w);
+                        on_stack[w] = 1;
+                        calls.push_back({w, m_first_edge[w]});
+                    }
+                    else if (on_stack[w])
+                        low[v] = std::min(low[v], order[w]);
+                    continue;
+                }
+                const std::size_t done = v;
+                calls.pop_back();
+                if (!calls.empty())
+                    low[calls.back().first] = std::min(low[calls.back().first], low[done]);
+                if (low[done] == order[done])
+                {
+                    std::vector<const void*> component;
+                    std::size_t w;
+                    do
+                    {
+                        w = stack.back();
+                        stack.pop_back();
+                        on_stack[w] = 0;
+                        component.push_back(m_entries[w].object);
+                    } while (w != done);
+                    if (component.size() > 1 || points_to_itself(done))
+                        result.push_back(std::move(component));
+                }
+            }
+        }
+        return result;
+    }
+
+    std::vector<entry> m_entries;
+    std::vector<std::size_t> m_first_edge;
+    std::vector<std::size_t> m_targets;
+    std::vector<std::size_t> m_leaked;
+};
+
+// The process wide registry behind register_for_cycle_check.
+inline cycle_registry& debug_cycle_registry()
+{
+    static cycle_registry registry;
+    return registry;
+}
+
+// Registers `object` in debug builds only.
+template <typename T>
+inline void register_for_cycle_check([[maybe_unused]] const std::shared_ptr<T>& object)
+{
+#ifndef NDEBUG
+    debug_cycle_registry().add(object);
+#endif
+}
@@ -0,0 +1,153 @@
+// A million Persons partnered up in pairs (shared_pointer_cyclic_problem.cpp
+// and weak_pointer.cpp, without the printing), built and torn down:
+//
+//   weak_edges              m_partner is a weak_ptr (weak_pointer.cpp):
+//                           dropping the owners frees everything
+//   shared_edges_by_hand    m_partner is a shared_ptr; every pair is
+//                           unpartnered by hand before the owners go
+//   shared_edges_collector  m_partner is a shared_ptr, every Person is
+//                           registered with a cycle_registry, the owners
+//                           are dropped (leaking every pair) and collect()
+//                           finds and breaks the cycles
+//
+// and the price of looking:
+//
+//   scan                    cycle_registry::scan() of the live graph
+//                           (nothing leaked)
+//
+// --people=N sets the number of Persons (default 1000000).
+
+#include "bench.h"
+#include "cycle_collector.h"
+
+#include <cstdio>
+#include <memory>
+#include <string>
+#include <vector>
+
+class Person
+{
+    std::string m_name;
+    std::shared_ptr<Person> m_partner;
+
+  public:
+    explicit Person(std::string name) : m_name(std::move(name)) {}
+
+    friend bool partnerUp(std::shared_ptr<Person>& p1, std::shared_ptr<Person>& p2)
+    {
+        if (!p1 || !p2)
+            return false;
+        p1->m_partner = p2;
+        p2->m_partner = p1;
+        return true;
+    }
+
+    void unpartner() { m_partner.reset(); }
+
+    template <typename Visit>
+    void for_each_shared_edge(Visit&& visit) const
+    {
+        visit(m_partner);
+    }
+    void break_shared_edges() { m_partner.reset(); }
+};
+
+class WeakPerson
+{
+    std::string m_name;
+    std::weak_ptr<WeakPerson> m_partner;
+
+  public:
+    explicit WeakPerson(std::string name) : m_name(std::move(name)) {}
+
+    friend bool partnerUp(std::shared_ptr<WeakPerson>& p1, std::shared_ptr<WeakPerson>& p2)
+    {
+        if (!p1 || !p2)
+            return false;
+        p1->m_partner = p2;
+        p2->m_partner = p1;
+        return true;
+    }
+};
+
+template <typename P>
+std::vector<std::shared_ptr<P>> make_couples(std::size_t people)
+{
+    std::vector<std::shared_ptr<P>> owners;
+    owners.reserve(people);
+    for (std::size_t i = 0; i < people; ++i)
+        owners.push_back(std::make_shared<P>("Person " + std::to_string(i)));
+    for (std::size_t i = 0; i + 1 < people; i += 2)
+        partnerUp(owners[i], owners[i + 1]);
+    return owners;
+}
+
+// What the numbers rely on: the registry finds the leaked pairs and
+// collect() frees them.
+bool collector_behaves()
+{
+    cycle_registry registry;
+    std::weak_ptr<Person> watch;
+    {
+        auto owners = make_couples<Person>(6);
+        for (const auto& p : owners)
+            registry.add(p);
+        watch = owners[0];
+        owners[2].reset();   // still owned by its partner, which is still owned from outside
+        const auto before = registry.scan();
+        if (before.leaked != 0 || before.live != 6)
+            return false;
+    }
+    const auto leaked = registry.scan();
+    if (leaked.leaked != 6 || leaked.cycles.size() != 3 || leaked.cycles[0].size() != 2 || watch.expired())
+        return false;
+    return registry.collect() == 6 && watch.expired() && registry.size() == 0;
+}
+
+int main(int argc, char** argv)
+{
+    bench::runner r("cycle_collector", argc, argv);
+
+    const auto people = static_cast<std::size_t>(r.param("people", r.size(1000000L, 10000L)));
+
+    r.run("partner_graph", "weak_edges", people, [&] {
+        auto owners = make_couples<WeakPerson>(people);
+        bench::do_not_optimize(owners.data());
+    });
+    r.run("partner_graph", "shared_edges_by_hand", people, [&] {
+        auto owners = make_couples<Person>(people);
+        for (auto& p : owners)
+            p->unpartner();
+        bench::do_not_optimize(owners.data());
+    });
+    r.run("partner_graph", "shared_edges_collector", people, [&] {
+        cycle_registry registry;
+        {
+            auto owners = make_couples<Person>(people);
+            for (const auto& p : owners)
+                registry.add(p);
+        }
+        bench::do_not_optimize(registry.collect());
+    });
+
+    {
+        auto owners = make_couples<Person>(people);
+        cycle_registry registry;
+        for (const auto& p : owners)
+            registry.add(p);
+        r.run("scan", "live_graph", people, [&] {
+            const auto report = registry.scan();
+            bench::do_not_optimize(report.leaked);
+        });
+        for (auto& p : owners)
+            p->unpartner();
+    }
+
+    if (!collector_behaves())
+    {
+        std::fprintf(stderr, "cycle_registry missed or misreported the leaked pairs\n");
+        return 1;
+    }
+
+    return r.finish();
+}
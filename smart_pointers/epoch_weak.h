@@ -0,0 +1,293 @@
+#pragma once
+
+// Batched weak_ptr lookups for observers that visit many partners per
+// tick (weak_pointer.cpp's Person::getPartner() in a loop).
+//
+// m_partner.lock() is a CAS loop on the partner's use count, and the
+// shared_ptr it returns costs a decrement when it goes: two locked
+// read-modify-writes per lookup, on a cache line every other observer
+// thread locking the same partner writes to as well.
+//
+// Epoch based reclamation moves that cost from every lookup to once
+// per batch. Objects made with make_epoch_shared are owned by ordinary
+// shared_ptrs, but when the last owner goes the object is not deleted
+// right away: it is retired to its epoch_domain and deleted only after
+// every epoch_guard that might still be looking at it has ended.
+// Inside a guard, then, "is it still alive?" is a plain load of the use
+// count (weak_ptr::expired), and the answer stays good, i.e. the object
+// stays readable, until the guard ends, whatever the owners do
+// meanwhile:
+//
+//   epoch_domain domain;
+//   auto lucy = make_epoch_shared<Person>(domain, "Lucy");
+//   ...
+//   {
+//       epoch_guard guard(domain);                      // one announcement
+//       for (const auto& p : people)
+//           if (const Person* partner = p->getPartner(guard))
+//               ...                                     // no count touched
+//   }                                                   // all released together
+//
+// pinned_batch does the same for a whole range at once and keeps the
+// pointers in a buffer that is reused from tick to tick.
+//
+// What a guarded pointer does not do is own: it must not outlive its
+// guard (lock() still gives a shared_ptr for that), and a long running
+// guard holds back the deletion of everything retired meanwhile, so
+// guards should be short, like one tick. An object may also be seen
+// after its last owner has gone (it is retired, not yet destroyed):
+// fine for reading, the same as with a shared_ptr obtained a moment
+// earlier.
+//
+// The domain has a fixed number of reader slots (guards active at the
+// same time, across all threads); an extra guard waits for a free one.
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include <utility>
+#include <vector>
+
+class epoch_domain
+{
+  public:
+    static constexpr std::size_t max_guards = 128;
+
+    epoch_domain() = default;
+    epoch_domain(const epoch_domain&) = delete;
+    epoch_domain& operator=(const epoch_domain&) = delete;
+
+    // No guards may be active any more; everything retired is deleted.
+    ~epoch_domain()
+    {
+        // deleting one may retire others
+        while (!m_retired.empty())
+            destroy(std::exchange(m_retired, {}));
+    }
+
+    // Hands an object whose last owner has gone to the domain; it is
+    // deleted once no guard can see it any more.
+    void retire(void* object, void (*destroy)(void*))
+    {
+        // pairs with the fence in enter(): either the guard sees the use
+        // count at zero, or we see its announcement (or a later epoch)
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        std::vector<retired_object> ready;
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_retired.push_back({object, destroy, m_epoch.load(std::memory_order_seq_cst)});
+            if (m_retired.size() >= m_next_collect)
+                ready = take_ready();
+        }
+        epoch_domain::destroy(std::move(ready));
+    }
+
+    // Deletes what can be deleted now. Happens by itself every so often
+    // while objects are retired.
+    void collect()
+    {
+        std::vector<retired_object> ready;
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            ready = take_ready();
+        }
+        destroy(std::move(ready));
+    }
+
+    std::size_t retired() const
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return m_retired.size();
+    }
+
+  private:
+    friend class epoch_guard;
+
+    // slot values: 0 free, otherwise (epoch << 1) | 1
+    struct alignas(64) slot
+    {
+        std::atomic<std::uint64_t> state{0};
+    };
+
+    struct retired_object
+    {
+        void* object;
+        void (*destroy)(void*);
+        std::uint64_t epoch;
+    };
+
+    std::size_t enter()
+    {
+        static thread_local std::size_t hint =
+            std::hash<std::thread::id>{}(std::this_thread::get_id()) % max_guards;
+        for (std::size_t i = hint, tried = 0;; i = (i + 1) % max_guards)
+        {
+            if (++tried % max_guards == 0)
+                std::this_thread::yield();   // went round once: every slot taken
+            std::uint64_t expected = 0;
+            const std::uint64_t epoch = m_epoch.load(std::memory_order_seq_cst);
+            if (m_slots[i].state.compare_exchange_strong(expected, (epoch << 1) | 1, std::memory_order_seq_cst))
+            {
+                std::atomic_thread_fence(std::memory_order_seq_cst);
+                hint = i;
+                return i;
+            }
+        }
+    }
+
+    void leave(std::size_t i) { m_slots[i].state.store(0, std::memory_order_release); }
+
+    // An object retired in epoch e may still be seen by guards that
+    // announced e or e + 1. The epoch only moves on once every active
+    // guard has announced the current one, so once it reaches e + 2 those
+    // guards have ended.
+    //
+    // Called with the mutex held; the caller deletes what it returns
+    // after letting go, as a destructor may drop the last owner of
+    // another object of the domain.
+    std::vector<retired_object> take_ready()
+    {
+        const std::uint64_t epoch = m_epoch.load(std::memory_order_seq_cst);
+        bool quiet = true;
+        for (const auto& s : m_slots)
+        {
+            const std::uint64_t state = s.state.load(std::memory_order_seq_cst);
+            if (state != 0 && (state >> 1) != epoch)
+            {
+                quiet = false;
+                break;
+            }
+        }
+        if (quiet)
+            m_epoch.store(epoch + 1, std::memory_order_seq_cst);
+        const std::uint64_t now = m_epoch.load(std::memory_order_relaxed);
+
+        std::vector<retired_object> ready;
+        std::size_t kept = 0;
+        for (const auto& r : m_retired)
+            if (r.epoch + 2 <= now)
+                ready.push_back(r);
+            else
+                m_retired[kept++] = r;
+        m_retired.resize(kept);
+        // amortized: collect again after as many new ones as are left
+        m_next_collect = std::max<std::size_t>(64, 2 * kept);
+        return ready;
+    }
+
+    static void destroy(std::vector<retired_object> objects)
+    {
+        for (const auto& r : objects)
+            r.destroy(r.object);
+    }
+
+    std::atomic<std::uint64_t> m_epoch{2};
+    slot m_slots[max_guards];
+    mutable std::mutex m_mutex;
+    std::vector<retired_object> m_retired;
+    std::size_t m_next_collect = 64;
+};
+
+// One reader's critical section: every object seen alive through an
+// epoch_weak_ptr while the guard is active stays readable until it ends.
+class epoch_guard
+{
+  public:
+    explicit epoch_guard(epoch_domain& domain) : m_domain(&domain), m_slot(domain.enter()) {}
+    epoch_guard(const epoch_guard&) = delete;
+    epoch_guard& operator=(const epoch_guard&) = delete;
+    ~epoch_guard() { m_domain->leave(m_slot); }
+
+  private:
+    epoch_domain* m_domain;
+    std::size_t m_slot;
+};
+
+// The shared_ptr deleter that defers to the domain.
+template <typename T>
+struct epoch_deleter
+{
+    epoch_domain* domain;
+    void operator()(T* object) const
+    {
+        domain->retire(const_cast<void*>(static_cast<const void*>(object)),
+                       [](void* p) { delete static_cast<T*>(p); });
+    }
+};
+
+// Like make_shared, but the object is deleted through `domain`. (Two
+// allocations, as with shared_ptr<T>(new T): with make_shared the object
+// lives inside the control block and is destroyed on the spot.)
+template <typename T, typename... Args>
+std::shared_ptr<T> make_epoch_shared(epoch_domain& domain, Args&&... args)
+{
+    return std::shared_ptr<T>(new T(std::forward<Args>(args)...), epoch_deleter<T>{&domain});
+}
+
+// A weak_ptr that can also be read under a guard without touching the
+// counts. Only for objects made with make_epoch_shared.
+template <typename T>
+class epoch_weak_ptr
+{
+  public:
+    epoch_weak_ptr() noexcept = default;
+    epoch_weak_ptr(const std::shared_ptr<T>& object) noexcept : m_ref(object), m_object(object.get()) {}
+
+    // The object if it was alive when looked at, else nullptr. Valid
+    // until the guard ends.
+    T* get(const epoch_guard&) const noexcept { return m_ref.expired() ? nullptr : m_object; }
+
+    std::shared_ptr<T> lock() const noexcept { return m_ref.lock(); }
+    bool expired() const noexcept { return m_ref.expired(); }
+
+  private:
+    std::weak_ptr<T> m_ref;
+    T* m_object = nullptr;
+};
+
+// Pins a whole range of epoch_weak_ptrs under one guard: pin() fills
+// the buffer (nullptr for the expired ones), release() lets them all go
+// at once. The buffer is kept, so a batch reused every tick does not
+// allocate.
+template <typename T>
+class pinned_batch
+{
+  public:
+    explicit pinned_batch(epoch_domain& domain) : m_domain(&domain) {}
+
+    // `pointer_of(element)` gives the epoch_weak_ptr<T> of an element of
+    // `range` (the identity by default).
+    template <typename Range, typename PointerOf>
+    const std::vector<T*>& pin(const Range& range, PointerOf&& pointer_of)
+    {
+        release();
+        m_guard.emplace(*m_domain);
+        for (const auto& element : range)
+            m_pinned.push_back(pointer_of(element).get(*m_guard));
+        return m_pinned;
+    }
+    template <typename Range>
+    const std::vector<T*>& pin(const Range& range)
+    {
+        return pin(range, [](const epoch_weak_ptr<T>& p) -> const epoch_weak_ptr<T>& { return p; });
+    }
+
+    const std::vector<T*>& pinned() const noexcept { return m_pinned; }
+
+    void release() noexcept
+    {
+        m_pinned.clear();
+        m_guard.reset();
+    }
+
+  private:
+    epoch_domain* m_domain;
+    std::optional<epoch_guard> m_guard;   // emplace: a guard cannot be moved
+    std::vector<T*> m_pinned;
+};
@@ -0,0 +1,229 @@
+// Observers looking up every Person's partner once per tick
+// (weak_pointer.cpp's getPartner(), without the printing), with several
+// observer threads walking the same Persons at once:
+//
+//   per_call_lock       std::weak_ptr::lock() per lookup, as in
+//                       weak_pointer.cpp: two locked RMWs on the
+//                       partner's control block, shared with the other
+//                       observers
+//   guard_per_call      epoch_weak_ptr with an epoch_guard per lookup:
+//                       the announcement instead of the counts
+//   guard_per_tick      one epoch_guard per tick, getPartner(guard)
+//   pinned_batch        pinned_batch::pin() of all partners per tick,
+//                       then the walk over the pinned pointers
+//
+// Groups for 1 observer and for --threads=N (default: the CPUs, at
+// least 2). ns/item is wall time per lookup and observer. --people=N
+// (default 100000) and --ticks=N (default 10) per observer.
+
+#include "bench.h"
+#include "epoch_weak.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+class Person
+{
+    std::string m_name;
+    std::weak_ptr<Person> m_partner;
+
+  public:
+    explicit Person(std::string name) : m_name(std::move(name)) {}
+
+    friend bool partnerUp(std::shared_ptr<Person>& p1, std::shared_ptr<Person>& p2)
+    {
+        if (!p1 || !p2)
+            return false;
+        p1->m_partner = p2;
+        p2->m_partner = p1;
+        return true;
+    }
+
+    const std::shared_ptr<Person> getPartner() const { return m_partner.lock(); }
+    const std::string& getName() const { return m_name; }
+};
+
+class EpochPerson
+{
+    std::string m_name;
+    epoch_weak_ptr<EpochPerson> m_partner;
+
+  public:
+    explicit EpochPerson(std::string name) : m_name(std::move(name)) {}
+
+    friend bool partnerUp(std::shared_ptr<EpochPerson>& p1, std::shared_ptr<EpochPerson>& p2)
+    {
+        if (!p1 || !p2)
+            return false;
+        p1->m_partner = p2;
+        p2->m_partner = p1;
+        return true;
+    }
+
+    const EpochPerson* getPartner(const epoch_guard& guard) const { return m_partner.get(guard); }
+    const epoch_weak_ptr<EpochPerson>& partner() const { return m_partner; }
+    const std::string& getName() const { return m_name; }
+};
+
+template <typename P, typename Make>
+std::vector<std::shared_ptr<P>> make_couples(std::size_t people, Make make)
+{
+    std::vector<std::shared_ptr<P>> owners;
+    owners.reserve(people);
+    for (std::size_t i = 0; i < people; ++i)
+        owners.push_back(make("Person " + std::to_string(i)));
+    for (std::size_t i = 0; i + 1 < people; i += 2)
+        partnerUp(owners[i], owners[i + 1]);
+    return owners;
+}
+
+// `threads` observers, each making its own `tick = make_tick()` and
+// running it `ticks` times.
+template <typename MakeTick>
+void observe(unsigned threads, long ticks, const MakeTick& make_tick)
+{
+    std::vector<std::thread> observers;
+    for (unsigned t = 0; t < threads; ++t)
+        observers.emplace_back([&] {
+            auto tick = make_tick();
+            std::size_t sum = 0;
+            for (long i = 0; i < ticks; ++i)
+                sum += tick();
+            bench::do_not_optimize(sum);
+        });
+    for (auto& t : observers)
+        t.join();
+}
+
+// What the numbers rely on: a partner whose last owner goes while a
+// guard is active stays readable until the guard ends, and is deleted
+// after that.
+struct Watched
+{
+    static inline int s_alive = 0;
+    int value = 42;
+    Watched() { ++s_alive; }
+    ~Watched() { --s_alive; }
+};
+
+bool epoch_weak_behaves()
+{
+    {
+        epoch_domain domain;
+        auto owner = make_epoch_shared<Watched>(domain);
+        const epoch_weak_ptr<Watched> weak = owner;
+        {
+            epoch_guard guard(domain);
+            const Watched* seen = weak.get(guard);
+            owner.reset();
+            domain.collect();
+            domain.collect();
+            domain.collect();
+            if (!seen || seen->value != 42 || Watched::s_alive != 1 || weak.get(guard) != nullptr)
+                return false;
+        }
+        domain.collect();
+        domain.collect();
+        if (Watched::s_alive != 0 || domain.retired() != 0)
+            return false;
+
+        // the batch: expired ones come back as nullptr
+        std::vector<std::shared_ptr<Watched>> owners;
+        std::vector<epoch_weak_ptr<Watched>> weaks;
+        for (int i = 0; i < 4; ++i)
+        {
+            owners.push_back(make_epoch_shared<Watched>(domain));
+            weaks.emplace_back(owners.back());
+        }
+        owners[1].reset();
+        pinned_batch<Watched> batch(domain);
+        const auto& pinned = batch.pin(weaks);
+        if (pinned.size() != 4 || !pinned[0] || pinned[1] || !pinned[2] || !pinned[3])
+            return false;
+        owners.clear();
+        if (pinned[3]->value != 42)
+            return false;
+        batch.release();
+    }
+    return Watched::s_alive == 0;
+}
+
+int main(int argc, char** argv)
+{
+    bench::runner r("epoch_weak", argc, argv);
+
+    const auto people = static_cast<std::size_t>(r.param("people", r.size(100000L, 2000L)));
+    const long ticks = r.param("ticks", 10);
+    const auto cpus = static_cast<long>(std::thread::hardware_concurrency());
+    const auto max_threads = static_cast<unsigned>(std::max(2L, r.param("threads", cpus)));
+    const auto items = static_cast<std::size_t>(people * ticks);
+
+    epoch_domain domain;
+    auto plain = make_couples<Person>(people, [](std::string name) { return std::make_shared<Person>(std::move(name)); });
+    auto epoch = make_couples<EpochPerson>(
+        people, [&](std::string name) { return make_epoch_shared<EpochPerson>(domain, std::move(name)); });
+
+    for (unsigned threads : {1u, max_threads})
+    {
+        const std::string group = "observers_" + std::to_string(threads) + "t";
+        // every observer thread gets its own tick from `make_tick`
+        auto run = [&](const char* name, auto make_tick) {
+            r.run(group, name, items, [&] { observe(threads, ticks, make_tick); });
+        };
+
+        run("per_call_lock", [&] {
+            return [&] {
+                std::size_t sum = 0;
+                for (const auto& p : plain)
+                    if (const auto partner = p->getPartner())
+                        sum += partner->getName().size();
+                return sum;
+            };
+        });
+        run("guard_per_call", [&] {
+            return [&] {
+                std::size_t sum = 0;
+                for (const auto& p : epoch)
+                {
+                    epoch_guard guard(domain);
+                    if (const auto* partner = p->getPartner(guard))
+                        sum += partner->getName().size();
+                }
+                return sum;
+            };
+        });
+        run("guard_per_tick", [&] {
+            return [&] {
+                std::size_t sum = 0;
+                epoch_guard guard(domain);
+                for (const auto& p : epoch)
+                    if (const auto* partner = p->getPartner(guard))
+                        sum += partner->getName().size();
+                return sum;
+            };
+        });
+        run("pinned_batch", [&] {
+            // reused every tick
+            return [&, batch = pinned_batch<EpochPerson>(domain)]() mutable {
+                std::size_t sum = 0;
+                for (const auto* partner : batch.pin(epoch, [](const auto& p) -> const auto& { return p->partner(); }))
+                    if (partner)
+                        sum += partner->getName().size();
+                batch.release();
+                return sum;
+            };
+        });
+    }
+
+    if (!epoch_weak_behaves())
+    {
+        std::fprintf(stderr, "epoch_weak_ptr freed too early or not at all\n");
+        return 1;
+    }
+
+    return r.finish();
+}
@@ -0,0 +1,168 @@
+#pragma once
+
+// An intrusive reference counted pointer: the count lives inside the
+// object instead of in a separate control block.
+//
+// shared_ptr<A>(new A) makes two allocations (A and its control block),
+// make_shared<A> one, and every shared_ptr is two pointers wide (the
+// object and the control block). With the count embedded in A there is
+// a single allocation, the pointer is one pointer wide, and a raw A* can
+// be turned back into an owning pointer at any time (the count is found
+// through the object), which shared_ptr can only do with
+// enable_shared_from_this.
+//
+// The price: the type has to opt in by deriving from ref_counted, there
+// are no weak pointers and no custom deleters, and a pointer to itself
+// (Resource::m_ptr in shared_pointer_cyclic_problem.cpp) still leaks.
+//
+//   struct A : ref_counted<A> { int M; ... };
+//   intrusive_ptr<A> p = make_intrusive<A>(5);
+//   intrusive_ptr<A> q = p;           // one increment, no control block
+//
+// The count is atomic by default. An object that never leaves one
+// thread can use single_thread_count: a plain increment, which is what
+// removes most of the cost of a copy (a locked read-modify-write is
+// some 20 cycles even without contention).
+//
+//   struct Node : ref_counted<Node, single_thread_count> { ... };
+//
+// For a class hierarchy derive the base, ref_counted<Base>, and give it
+// a virtual destructor; intrusive_ptr<Derived> then converts to
+// intrusive_ptr<Base> like shared_ptr does.
+
+#include <atomic>
+#include <cstddef>
+#include <utility>
+
+// Counter policies for ref_counted.
+class atomic_count
+{
+  public:
+    void increment() noexcept { m_count.fetch_add(1, std::memory_order_relaxed); }
+
+    // First reference of a new object, nobody else can see it yet: a
+    // plain store instead of a locked increment.
+    void set_one() noexcept { m_count.store(1, std::memory_order_relaxed); }
+
+    // true when that was the last reference. acq_rel: the deleting
+    // thread has to see every write made through the other references.
+    bool decrement() noexcept { return m_count.fetch_sub(1, std::memory_order_acq_rel) == 1; }
+
+    long value() const noexcept { return m_count.load(std::memory_order_relaxed); }
+
+  private:
+    std::atomic<long> m_count{0};
+};
+
+class single_thread_count
+{
+  public:
+    void increment() noexcept { ++m_count; }
+    void set_one() noexcept { m_count = 1; }
+    bool decrement() noexcept { return --m_count == 0; }
+    long value() const noexcept { return m_count; }
+
+  private:
+    long m_count = 0;
+};
+
+// Base of every type managed by intrusive_ptr. T is the most derived
+// type (it is deleted as a T, so no virtual destructor is needed).
+template <typename T, typename Count = atomic_count>
+class ref_counted
+{
+  public:
+    long use_count() const noexcept { return m_count.value(); }
+
+  protected:
+    ref_counted() = default;
+    // a copy of the object is a new object, with no references yet
+    ref_counted(const ref_counted&) noexcept {}
+    ref_counted& operator=(const ref_counted&) noexcept { return *this; }
+    ~ref_counted() = default;
+
+  private:
+    friend void intrusive_ptr_add_ref(const ref_counted* p) noexcept { p->m_count.increment(); }
+    friend void intrusive_ptr_add_first_ref(const ref_counted* p) noexcept { p->m_count.set_one(); }
+
+    friend void intrusive_ptr_release(const ref_counted* p) noexcept
+    {
+        if (p->m_count.decrement())
+            delete static_cast<const T*>(p);
+    }
+
+    mutable Count m_count;
+};
+
+// Tag: the pointer takes over a reference the caller already holds.
+struct adopt_ref_t
+{
+};
+inline constexpr adopt_ref_t adopt_ref{};
+
+template <typename T>
+class intrusive_ptr
+{
+  public:
+    using element_type = T;
+
+    intrusive_ptr() noexcept = default;
+
+    // Takes a reference to `p` (which may already be owned elsewhere).
+    explicit intrusive_ptr(T* p) noexcept : m_ptr(p)
+    {
+        if (m_ptr)
+            intrusive_ptr_add_ref(m_ptr);
+    }
+
+    intrusive_ptr(T* p, adopt_ref_t) noexcept : m_ptr(p) {}
+
+    intrusive_ptr(const intrusive_ptr& other) noexcept : intrusive_ptr(other.m_ptr) {}
+    intrusive_ptr(intrusive_ptr&& other) noexcept : m_ptr(std::exchange(other.m_ptr, nullptr)) {}
+
+    // Derived -> Base
+    template <typename U>
+    intrusive_ptr(const intrusive_ptr<U>& other) noexcept : intrusive_ptr(other.get())
+    {
+    }
+    template <typename U>
+    intrusive_ptr(intrusive_ptr<U>&& other) noexcept : m_ptr(other.detach())
+    {
+    }
+
+    intrusive_ptr& operator=(intrusive_ptr other) noexcept
+    {
+        std::swap(m_ptr, other.m_ptr);
+        return *this;
+    }
+
+    ~intrusive_ptr()
+    {
+        if (m_ptr)
+            intrusive_ptr_release(m_ptr);
+    }
+
+    void reset() noexcept { intrusive_ptr().swap(*this); }
+    void swap(intrusive_ptr& other) noexcept { std::swap(m_ptr, other.m_ptr); }
+
+    // Gives up ownership without releasing: the caller now holds the reference.
+    T* detach() noexcept { return std::exchange(m_ptr, nullptr); }
+
+    T* get() const noexcept { return m_ptr; }
+    T& operator*() const noexcept { return *m_ptr; }
+    T* operator->() const noexcept { return m_ptr; }
+    explicit operator bool() const noexcept { return m_ptr != nullptr; }
+
+    friend bool operator==(const intrusive_ptr& a, const intrusive_ptr& b) noexcept { return a.m_ptr == b.m_ptr; }
+
+  private:
+    T* m_ptr = nullptr;
+};
+
+template <typename T, typename... Args>
+intrusive_ptr<T> make_intrusive(Args&&... args)
+{
+    T* p = new T(std::forward<Args>(args)...);
+    intrusive_ptr_add_first_ref(p);
+    return intrusive_ptr<T>(p, adopt_ref);
+}
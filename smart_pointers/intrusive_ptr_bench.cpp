@@ -0,0 +1,162 @@
+// Benchmark for intrusive_ptr.h against std::shared_ptr, for the `A`
+// of shared_pointer.cpp.
+//
+// create_destroy  one owning pointer made and dropped per item:
+//                 shared_ptr<A>(new A) (two allocations), make_shared
+//                 (one), make_intrusive with an atomic and with a
+//                 single thread count (one, no control block)
+// copy_destroy    a copy passed by value and destroyed, i.e. the
+//                 refcount traffic of On_topic_copying/shared_ptr
+// hold_many       a million pointers to distinct objects kept alive,
+//                 then walked: smaller pointers and no control block
+//                 to touch mean less memory traffic
+//
+// libstdc++'s shared_ptr quietly uses plain increments while the
+// process has never started a thread (glibc's __libc_single_threaded),
+// which would make it look like single_thread_count here. Real programs
+// that share pointers have threads, so a thread is started (and joined)
+// first; --threaded=0 measures the single threaded process instead.
+
+#include "bench.h"
+#include "intrusive_ptr.h"
+
+#include <cstdio>
+#include <memory>
+#include <thread>
+#include <vector>
+
+struct A
+{
+    int M;
+    A(int m) : M(m) {}
+};
+
+struct IntrusiveA : ref_counted<IntrusiveA>
+{
+    int M;
+    IntrusiveA(int m) : M(m) {}
+};
+
+struct LocalA : ref_counted<LocalA, single_thread_count>
+{
+    int M;
+    LocalA(int m) : M(m) {}
+};
+
+// shared_pointer_cyclic_problem.cpp's Resource: the self reference
+// works the same way (and leaks the same way if it is never reset).
+struct Resource : ref_counted<Resource>
+{
+    intrusive_ptr<Resource> m_ptr;
+};
+
+template <typename Ptr>
+BENCH_NOINLINE int use_by_value(Ptr p)
+{
+    return p->M;
+}
+
+// Resource's self reference keeps it alive until it is broken by hand.
+bool resource_cycle_behaves()
+{
+    auto ptr1 = make_intrusive<Resource>();
+    ptr1->m_ptr = ptr1;
+    Resource* raw = ptr1.get();
+    const bool shared = raw->use_count() == 2;
+    ptr1.reset();
+    const bool alive = raw->use_count() == 1;
+    raw->m_ptr.reset();   // the last reference: deletes it
+    return shared && alive;
+}
+
+int main(int argc, char** argv)
+{
+    bench::runner r("intrusive_ptr", argc, argv);
+
+    if (r.param("threaded", 1))
+        std::thread([] {}).join();
+
+    std::printf("  sizeof: shared_ptr<A> %zu, intrusive_ptr<A> %zu\n", sizeof(std::shared_ptr<A>),
+                sizeof(intrusive_ptr<IntrusiveA>));
+
+    const int loops = r.size(10000000, 10000);
+
+    r.run("create_destroy", "shared_ptr(new A)", loops, [&] {
+        for (int i = 0; i < loops; ++i)
+        {
+            std::shared_ptr<A> p(new A(i));
+            bench::do_not_optimize(p);
+        }
+    });
+    r.run("create_destroy", "make_shared", loops, [&] {
+        for (int i = 0; i < loops; ++i)
+        {
+            auto p = std::make_shared<A>(i);
+            bench::do_not_optimize(p);
+        }
+    });
+    r.run("create_destroy", "make_intrusive", loops, [&] {
+        for (int i = 0; i < loops; ++i)
+        {
+            auto p = make_intrusive<IntrusiveA>(i);
+            bench::do_not_optimize(p);
+        }
+    });
+    r.run("create_destroy", "make_intrusive_single_thread", loops, [&] {
+        for (int i = 0; i < loops; ++i)
+        {
+            auto p = make_intrusive<LocalA>(i);
+            bench::do_not_optimize(p);
+        }
+    });
+
+    {
+        auto shared = std::make_shared<A>(1);
+        auto intrusive = make_intrusive<IntrusiveA>(1);
+        auto local = make_intrusive<LocalA>(1);
+        r.run("copy_destroy", "shared_ptr", loops, [&] {
+            int sum = 0;
+            for (int i = 0; i < loops; ++i)
+                sum += use_by_value(shared);
+            bench::do_not_optimize(sum);
+        });
+        r.run("copy_destroy", "intrusive_ptr", loops, [&] {
+            int sum = 0;
+            for (int i = 0; i < loops; ++i)
+                sum += use_by_value(intrusive);
+            bench::do_not_optimize(sum);
+        });
+        r.run("copy_destroy", "intrusive_ptr_single_thread", loops, [&] {
+            int sum = 0;
+            for (int i = 0; i < loops; ++i)
+                sum += use_by_value(local);
+            bench::do_not_optimize(sum);
+        });
+    }
+
+    const std::size_t objects = r.size<std::size_t>(1000000, 10000);
+    auto hold = [&](const char* name, auto make) {
+        r.run("hold_many", name, objects, [&] {
+            std::vector<decltype(make(0))> v;
+            v.reserve(objects);
+            for (std::size_t i = 0; i < objects; ++i)
+                v.push_back(make(static_cast<int>(i)));
+            long sum = 0;
+            for (const auto& p : v)
+                sum += p->M;
+            bench::do_not_optimize(sum);
+        });
+    };
+    hold("shared_ptr(new A)", [](int i) { return std::shared_ptr<A>(new A(i)); });
+    hold("make_shared", [](int i) { return std::make_shared<A>(i); });
+    hold("make_intrusive", [](int i) { return make_intrusive<IntrusiveA>(i); });
+    hold("make_intrusive_single_thread", [](int i) { return make_intrusive<LocalA>(i); });
+
+    if (!resource_cycle_behaves())
+    {
+        std::fprintf(stderr, "intrusive_ptr reference counts are off\n");
+        return 1;
+    }
+
+    return r.finish();
+}
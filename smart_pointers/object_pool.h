@@ -0,0 +1,211 @@
+#pragma once
+
+// A typed object pool behind unique_ptr, for code that keeps making and
+// dropping objects of one type (unique_pointer.cpp's make_unique<example>,
+// funcOut and funcIn, in a loop).
+//
+//   pool_unique_ptr<example> p = make_pool_unique<example>("Jack");
+//   funcIn(std::move(p));              // the slot goes back to the pool
+//
+// pool_unique_ptr<T> is a std::unique_ptr<T, pool_deleter<T>>: the
+// deleter is empty, so the pointer is still one pointer wide, and
+// everything unique_pointer.cpp shows (move, swap, reset, release, get)
+// works unchanged. Only release() is different in spirit: the raw
+// pointer has to go back through pool_deleter<T>, not delete.
+//
+// The memory comes in slabs of slab_slots objects from operator new and
+// is never given back while the program runs; freed slots are kept on
+// free lists, threaded through the free slots themselves:
+//
+//   - every thread has its own cache of up to 2 * batch free slots, so
+//     making and dropping objects is a push or pop on a thread local
+//     list: no lock, no atomic, no malloc
+//   - an empty cache takes a batch from the shared list (one lock per
+//     batch), a full one gives a batch back; that keeps a thread that
+//     only frees objects made by another thread (a producer/consumer
+//     hand-off) from hoarding
+//   - a thread's cache goes back to the shared list when the thread ends
+//
+// There is one pool per type, object_pool<T>::instance().
+
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <utility>
+#include <vector>
+
+template <typename T>
+class object_pool
+{
+  public:
+    static constexpr std::size_t slab_slots = 1024;
+    static constexpr std::size_t batch = 64;
+
+    static object_pool& instance() noexcept { return s_pool; }
+
+    object_pool(const object_pool&) = delete;
+    object_pool& operator=(const object_pool&) = delete;
+
+    // Raw storage for one T.
+    void* allocate()
+    {
+        cache& local = s_cache;
+        if (!local.head)
+            refill(local);
+        slot* s = local.head;
+        local.head = s->next;
+        --local.count;
+        return s;
+    }
+
+    void deallocate(void* p) noexcept
+    {
+        cache& local = s_cache;
+        if (!local.registered)
+            register_owner(local);   // a thread that only ever frees
+        slot* s = static_cast<slot*>(p);
+        s->next = local.head;
+        local.head = s;
+        if (++local.count >= 2 * batch)
+            give_back(local, batch);
+    }
+
+    // Slabs made so far.
+    std::size_t slabs() noexcept
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return m_slabs.size();
+    }
+
+    ~object_pool()
+    {
+        for (void* slab : m_slabs)
+            ::operator delete(slab, std::align_val_t(alignof(slot)));
+    }
+
+  private:
+    union slot
+    {
+        slot* next;
+        alignas(T) unsigned char storage[sizeof(T)];
+    };
+
+    // Trivial, so that getting at it is a plain thread local access: a
+    // thread local with a destructor is reached through a wrapper call
+    // that checks whether it is initialized yet.
+    struct cache
+    {
+        slot* head = nullptr;
+        std::size_t count = 0;
+        bool registered = false;   // has a cache_owner
+    };
+
+    // Hands the cache back when the thread ends; set up on the slow path
+    // (refill, or the first free of a thread that never allocates).
+    struct cache_owner
+    {
+        ~cache_owner()
+        {
+            if (s_cache.count)
+                s_pool.give_back(s_cache, s_cache.count);
+        }
+    };
+
+    constexpr object_pool() = default;
+
+    // Moves up to `batch` slots from the shared list to `local`, making a
+    // new slab first if the shared list is empty.
+    void refill(cache& local)
+    {
+        if (!local.registered)
+            register_owner(local);
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (!m_free)
+            add_slab();
+        while (m_free && local.count < batch)
+        {
+            slot* s = m_free;
+            m_free = s->next;
+            s->next = local.head;
+            local.head = s;
+            ++local.count;
+        }
+    }
+
+    static void register_owner(cache& local) noexcept
+    {
+        static thread_local cache_owner owner;
+        (void)owner;
+        local.registered = true;
+    }
+
+    void give_back(cache& local, std::size_t n) noexcept
+    {
+        // unlink n slots locally, then splice them in under the lock
+        slot* first = local.head;
+        slot* last = first;
+        for (std::size_t i = 1; i < n; ++i)
+            last = last->next;
+        local.head = last->next;
+        local.count -= n;
+        std::lock_guard<std::mutex> lock(m_mutex);
+        last->next = m_free;
+        m_free = first;
+    }
+
+    void add_slab()
+    {
+        auto* slots = static_cast<slot*>(::operator new(slab_slots * sizeof(slot), std::align_val_t(alignof(slot))));
+        m_slabs.push_back(slots);
+        for (std::size_t i = 0; i < slab_slots; ++i)
+        {
+            slots[i].next = m_free;
+            m_free = &slots[i];
+        }
+    }
+
+    // constant initialized: no guard on instance() either
+    static object_pool s_pool;
+    static inline thread_local cache s_cache;
+
+    std::mutex m_mutex;
+    slot* m_free = nullptr;
+    std::vector<void*> m_slabs;
+};
+
+template <typename T>
+constinit object_pool<T> object_pool<T>::s_pool;
+
+template <typename T>
+struct pool_deleter
+{
+    void operator()(T* p) const noexcept
+    {
+        p->~T();
+        object_pool<T>::instance().deallocate(p);
+    }
+};
+
+template <typename T>
+using pool_unique_ptr = std::unique_ptr<T, pool_deleter<T>>;
+
+// make_unique for pooled objects.
+template <typename T, typename... Args>
+pool_unique_ptr<T> make_pool_unique(Args&&... args)
+{
+    // gives the slot back if T's constructor throws; with a try/catch
+    // instead GCC stops inlining this, which costs more than the pool saves
+    struct slot_guard
+    {
+        void* storage;
+        ~slot_guard()
+        {
+            if (storage)
+                object_pool<T>::instance().deallocate(storage);
+        }
+    } guard{object_pool<T>::instance().allocate()};
+    T* object = ::new (guard.storage) T(std::forward<Args>(args)...);
+    guard.storage = nullptr;
+    return pool_unique_ptr<T>(object);
+}
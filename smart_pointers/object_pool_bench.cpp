@@ -0,0 +1,206 @@
+// unique_pointer.cpp's `example`, made and dropped over and over with
+// make_unique and with make_pool_unique (object_pool.h):
+//
+// create_destroy   make one, drop it
+// funcOut_funcIn   x = funcOut(); funcIn(std::move(x)): made in one
+//                  function, handed back, moved into another, dropped
+// churn            a window of --live=N (default 10000) objects, one at
+//                  a random position replaced per item: the heap's (or
+//                  the pool's) free lists get well mixed
+// churn_Nt         the same on --threads=N threads at once (default:
+//                  the CPUs, at least 2), ns/item per thread
+// handoff_Nt       every thread makes its share, then frees the share of
+//                  the next thread: each object dies on another thread
+//                  than the one that made it
+//
+// Names fit std::string's small buffer, so the only allocation measured
+// is the object's own.
+
+#include "bench.h"
+#include "object_pool.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <memory>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+class example
+{
+  public:
+    example(std::string n) : Name(std::move(n)) {}
+    std::string Name;
+};
+
+BENCH_NOINLINE void funcIn(std::unique_ptr<example> a)
+{
+    bench::do_not_optimize(a.get());
+}
+
+BENCH_NOINLINE std::unique_ptr<example> funcOut()
+{
+    auto a = std::make_unique<example>("savio");
+    return a;
+}
+
+BENCH_NOINLINE void pool_funcIn(pool_unique_ptr<example> a)
+{
+    bench::do_not_optimize(a.get());
+}
+
+BENCH_NOINLINE pool_unique_ptr<example> pool_funcOut()
+{
+    auto a = make_pool_unique<example>("savio");
+    return a;
+}
+
+struct use_make_unique
+{
+    static std::unique_ptr<example> make(const char* name) { return std::make_unique<example>(name); }
+};
+
+struct use_pool
+{
+    static pool_unique_ptr<example> make(const char* name) { return make_pool_unique<example>(name); }
+};
+
+template <typename Make>
+void churn(std::size_t live, std::size_t replacements, unsigned seed)
+{
+    std::vector<decltype(Make::make(""))> window;
+    window.reserve(live);
+    for (std::size_t i = 0; i < live; ++i)
+        window.push_back(Make::make("Jack"));
+    std::minstd_rand rng(seed);
+    for (std::size_t i = 0; i < replacements; ++i)
+        window[rng() % live] = Make::make("Stafania");
+    bench::do_not_optimize(window.data());
+}
+
+template <typename Body>
+void on_threads(unsigned threads, const Body& body)
+{
+    std::vector<std::thread> workers;
+    for (unsigned t = 0; t < threads; ++t)
+        workers.emplace_back([&, t] { body(t); });
+    for (auto& w : workers)
+        w.join();
+}
+
+template <typename Make>
+void handoff(unsigned threads, std::size_t per_thread)
+{
+    std::vector<std::vector<decltype(Make::make(""))>> shares(threads);
+    on_threads(threads, [&](unsigned t) {
+        shares[t].reserve(per_thread);
+        for (std::size_t i = 0; i < per_thread; ++i)
+            shares[t].push_back(Make::make("Jack"));
+    });
+    on_threads(threads, [&](unsigned t) { shares[(t + 1) % threads].clear(); });
+}
+
+// What the numbers rely on: slots are reused, objects are really
+// constructed and destroyed, and slots freed on another thread come back.
+bool pool_behaves()
+{
+    const void* first = nullptr;
+    {
+        auto p = make_pool_unique<example>("Jack");
+        first = p.get();
+        p->Name = "Stafania";
+    }
+    auto q = make_pool_unique<example>("Savio");
+    if (q.get() != first || q->Name != "Savio")
+        return false;
+
+    std::vector<pool_unique_ptr<example>> made;
+    std::thread maker([&] {
+        for (int i = 0; i < 1000; ++i)
+            made.push_back(make_pool_unique<example>(std::to_string(i)));
+    });
+    maker.join();
+    for (int i = 0; i < 1000; ++i)
+        if (made[static_cast<std::size_t>(i)]->Name != std::to_string(i))
+            return false;
+    made.clear();
+
+    // A thread that only frees (the consumer of a hand-off) must give its
+    // cache back when it ends as well: otherwise every such thread keeps
+    // up to 2 * batch slots, and the pool keeps adding slabs.
+    // A type of its own, so that its pool has no slack from the runs.
+    struct handed_off
+    {
+        int value;
+    };
+    auto hand_off = [] {
+        std::vector<pool_unique_ptr<handed_off>> objects;
+        for (int i = 0; i < 1000; ++i)
+            objects.push_back(make_pool_unique<handed_off>(i));
+        std::thread([objects = std::move(objects)]() mutable { objects.clear(); }).join();
+    };
+    hand_off();
+    const std::size_t slabs = object_pool<handed_off>::instance().slabs();
+    for (int round = 0; round < 20; ++round)
+        hand_off();
+    return object_pool<handed_off>::instance().slabs() == slabs;
+}
+
+int main(int argc, char** argv)
+{
+    bench::runner r("object_pool", argc, argv);
+
+    const std::size_t n = r.size(1000000, 10000);
+    const auto live = static_cast<std::size_t>(r.param("live", 10000));
+    const auto cpus = static_cast<long>(std::thread::hardware_concurrency());
+    const auto threads = static_cast<unsigned>(std::max(2L, r.param("threads", cpus)));
+
+    // libstdc++ and glibc take cheaper paths while the process has never
+    // started a thread; the threaded groups below start some anyway
+    std::thread([] {}).join();
+
+    r.run("create_destroy", "make_unique", n, [&] {
+        for (std::size_t i = 0; i < n; ++i)
+        {
+            auto p = std::make_unique<example>("Jack");
+            bench::do_not_optimize(p.get());
+        }
+    });
+    r.run("create_destroy", "make_pool_unique", n, [&] {
+        for (std::size_t i = 0; i < n; ++i)
+        {
+            auto p = make_pool_unique<example>("Jack");
+            bench::do_not_optimize(p.get());
+        }
+    });
+
+    r.run("funcOut_funcIn", "make_unique", n, [&] {
+        for (std::size_t i = 0; i < n; ++i)
+            funcIn(funcOut());
+    });
+    r.run("funcOut_funcIn", "make_pool_unique", n, [&] {
+        for (std::size_t i = 0; i < n; ++i)
+            pool_funcIn(pool_funcOut());
+    });
+
+    r.run("churn", "make_unique", n, [&] { churn<use_make_unique>(live, n, 1); });
+    r.run("churn", "make_pool_unique", n, [&] { churn<use_pool>(live, n, 1); });
+
+    const std::string suffix = "_" + std::to_string(threads) + "t";
+    r.run("churn" + suffix, "make_unique", n,
+          [&] { on_threads(threads, [&](unsigned t) { churn<use_make_unique>(live, n, t + 1); }); });
+    r.run("churn" + suffix, "make_pool_unique", n,
+          [&] { on_threads(threads, [&](unsigned t) { churn<use_pool>(live, n, t + 1); }); });
+
+    r.run("handoff" + suffix, "make_unique", n, [&] { handoff<use_make_unique>(threads, n); });
+    r.run("handoff" + suffix, "make_pool_unique", n, [&] { handoff<use_pool>(threads, n); });
+
+    if (!pool_behaves())
+    {
+        std::fprintf(stderr, "object_pool did not reuse or keep its slots\n");
+        return 1;
+    }
+
+    return r.finish();
+}
@@ -85,4 +85,6 @@ int main()
 // up keeping “Lucy” from being destroyed.
 
 // It turns out that this can happen any time shared pointers 
-// form a circular reference
\ No newline at end of file
+// form a circular reference
+// In a big object graph such cycles are hard to spot by reading the
+// code: cycle_collector.h finds (and can break) them at runtime.
@@ -0,0 +1,58 @@
+// What a table of factorials costs the compiler, built three ways
+// (compile_time_variants.cpp): class template recursion as in
+// meta_programming.cpp, a constexpr function, a consteval function. Each
+// case runs the compiler that built this benchmark (-fsyntax-only, so
+// only the front end and the constant evaluator) on the variants source,
+// for tables of 256, 1024 and 4096 entries (up to 1024 with --quick).
+//
+// ns/item is per table entry and includes starting the compiler; the
+// startup group (the source with no variant selected) is that part on
+// its own. Template recursion needs -ftemplate-depth above the table
+// size, and its cost per entry grows with the size: every Factorial<N>
+// is a class the compiler keeps until the end. The two functions are the
+// same loop run by the constant evaluator.
+
+#include "bench.h"
+
+#include <cctype>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+
+bool compile(const std::string& defines)
+{
+    const std::string command = std::string("\"") + COMPILE_TIME_CXX +
+                                "\" -std=c++20 -fsyntax-only -ftemplate-depth=5000 " + defines + " \"" +
+                                COMPILE_TIME_SOURCE + "\"";
+    return std::system(command.c_str()) == 0;
+}
+
+int main(int argc, char** argv)
+{
+    bench::runner r("compile_time", argc, argv);
+
+    bool compiled = true;
+    r.run("startup", "no_table", 1, [&] { compiled &= compile(""); });
+
+    const std::size_t largest = r.size<std::size_t>(4096, 1024);
+    for (std::size_t n = 256; n <= largest; n *= 4)
+    {
+        const std::string group = "factorial_table_" + std::to_string(n);
+        const std::string size = "-DTABLE_SIZE=" + std::to_string(n);
+        for (const char* variant : {"TEMPLATE_RECURSION", "CONSTEXPR", "CONSTEVAL"})
+        {
+            std::string name = variant;
+            for (char& c : name)
+                c = static_cast<char>(std::tolower(static_cast<unsigned char>(c)));
+            const std::string defines = size + " -DVARIANT_" + variant;
+            r.run(group, name, n, [&] { compiled &= compile(defines); });
+        }
+    }
+
+    if (!compiled)
+    {
+        std::fprintf(stderr, "%s did not compile\n", COMPILE_TIME_SOURCE);
+        return 1;
+    }
+    return r.finish();
+}
@@ -0,0 +1,76 @@
+// A table of TABLE_SIZE factorials (mod 2^64) built three ways, one per
+// VARIANT_* define, for compile_time_bench to hand to the compiler. Not
+// part of the build; with no VARIANT_* it is the empty baseline (just
+// the includes), i.e. what starting the compiler costs.
+//
+//   VARIANT_TEMPLATE_RECURSION  meta_programming.cpp's Factorial<N>, one
+//                               class per entry, spread into an array
+//                               with an index_sequence
+//   VARIANT_CONSTEXPR           a constexpr function filling the array
+//   VARIANT_CONSTEVAL           the same function, consteval
+//                               (make_table of lookup_tables.h)
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+
+#ifndef TABLE_SIZE
+#define TABLE_SIZE 256
+#endif
+
+#if defined(VARIANT_TEMPLATE_RECURSION)
+
+template <std::size_t N>
+struct Factorial
+{
+    static constexpr std::uint64_t value = N * Factorial<N - 1>::value;
+};
+
+template <>
+struct Factorial<0>
+{
+    static constexpr std::uint64_t value = 1;
+};
+
+template <std::size_t... I>
+constexpr std::array<std::uint64_t, sizeof...(I)> factorial_array(std::index_sequence<I...>)
+{
+    return {Factorial<I>::value...};
+}
+
+constexpr auto factorials = factorial_array(std::make_index_sequence<TABLE_SIZE>());
+
+#elif defined(VARIANT_CONSTEXPR) || defined(VARIANT_CONSTEVAL)
+
+#if defined(VARIANT_CONSTEXPR)
+#define TABLE_FUNCTION constexpr
+#else
+#define TABLE_FUNCTION consteval
+#endif
+
+TABLE_FUNCTION std::array<std::uint64_t, TABLE_SIZE> factorial_array()
+{
+    std::array<std::uint64_t, TABLE_SIZE> table{};
+    table[0] = 1;
+    for (std::size_t n = 1; n < table.size(); ++n)
+        table[n] = n * table[n - 1];
+    return table;
+}
+
+constexpr auto factorials = factorial_array();
+
+#endif
+
+#if defined(VARIANT_TEMPLATE_RECURSION) || defined(VARIANT_CONSTEXPR) || defined(VARIANT_CONSTEVAL)
+static_assert(factorials[20] == 2432902008176640000ull);
+
+int main()
+{
+    return static_cast<int>(factorials[TABLE_SIZE - 1] & 1);
+}
+#else
+int main()
+{
+}
+#endif
@@ -0,0 +1,110 @@
+// The tables of lookup_tables.h against computing the same values on
+// the fly, over --queries=N random arguments (default 10^6):
+//
+// factorial  factorials[n] against a multiply loop, n in 0 .. 20
+// binomial   binomials[n][k] against the multiplicative formula, n up to
+//            62 (beyond that its intermediate products overflow 64 bits)
+// crc32      the byte table against shifting through every bit, over a
+//            buffer of the same N bytes; items are bytes
+// isqrt      isqrt_table[x] against isqrt() and against std::sqrt, x in
+//            0 .. 65535
+//
+// A lookup is one load, where the loop has to run; but a table that does
+// not stay in the cache (isqrt_table is 64 KiB) turns the load into a
+// cache miss, and then a few instructions of arithmetic win.
+
+#include "bench.h"
+#include "lookup_tables.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <random>
+#include <vector>
+
+std::uint64_t factorial_loop(unsigned n)
+{
+    std::uint64_t f = 1;
+    for (unsigned i = 2; i <= n; ++i)
+        f *= i;
+    return f;
+}
+
+std::uint64_t binomial_formula(unsigned n, unsigned k)
+{
+    k = std::min(k, n - k);
+    std::uint64_t c = 1;
+    for (unsigned i = 1; i <= k; ++i)
+        c = c * (n - k + i) / i;
+    return c;
+}
+
+std::uint32_t crc32_bitwise(const unsigned char* data, std::size_t size)
+{
+    std::uint32_t crc = 0xFFFFFFFFu;
+    for (std::size_t i = 0; i < size; ++i)
+        crc = crc32_byte(crc ^ data[i]);
+    return crc ^ 0xFFFFFFFFu;
+}
+
+template <typename F>
+std::uint64_t sum_over(const std::vector<std::uint32_t>& args, F f)
+{
+    std::uint64_t sum = 0;
+    for (std::uint32_t a : args)
+        sum += f(a);
+    return sum;
+}
+
+int main(int argc, char** argv)
+{
+    bench::runner r("lookup_table", argc, argv);
+
+    const auto n = static_cast<std::size_t>(r.param("queries", r.size(1000000L, 100000L)));
+    std::mt19937 rng(42);
+    std::vector<std::uint32_t> small(n), pairs(n), wide(n);
+    std::vector<unsigned char> bytes(n);
+    for (std::size_t i = 0; i < n; ++i)
+    {
+        small[i] = rng() % 21;
+        const std::uint32_t row = rng() % 63;
+        pairs[i] = row << 8 | rng() % (row + 1);
+        wide[i] = rng() & 0xFFFFu;
+        bytes[i] = static_cast<unsigned char>(rng());
+    }
+
+    bool agree = true;
+
+    const auto fact_table = [](std::uint32_t a) { return factorials[a]; };
+    const auto fact_loop = [](std::uint32_t a) { return factorial_loop(a); };
+    agree &= sum_over(small, fact_table) == sum_over(small, fact_loop);
+    r.run("factorial", "loop", n, [&] { bench::do_not_optimize(sum_over(small, fact_loop)); });
+    r.run("factorial", "table", n, [&] { bench::do_not_optimize(sum_over(small, fact_table)); });
+
+    const auto binom_table = [](std::uint32_t a) { return binomials[a >> 8][a & 0xFFu]; };
+    const auto binom_formula = [](std::uint32_t a) { return binomial_formula(a >> 8, a & 0xFFu); };
+    agree &= sum_over(pairs, binom_table) == sum_over(pairs, binom_formula);
+    r.run("binomial", "formula", n, [&] { bench::do_not_optimize(sum_over(pairs, binom_formula)); });
+    r.run("binomial", "table", n, [&] { bench::do_not_optimize(sum_over(pairs, binom_table)); });
+
+    agree &= crc32(bytes.data(), n) == crc32_bitwise(bytes.data(), n);
+    r.run("crc32", "bitwise", n, [&] { bench::do_not_optimize(crc32_bitwise(bytes.data(), n)); });
+    r.run("crc32", "table", n, [&] { bench::do_not_optimize(crc32(bytes.data(), n)); });
+
+    const auto root_table = [](std::uint32_t a) { return std::uint32_t(isqrt_table[a]); };
+    const auto root_bitwise = [](std::uint32_t a) { return isqrt(a); };
+    const auto root_float = [](std::uint32_t a) { return static_cast<std::uint32_t>(std::sqrt(double(a))); };
+    agree &= sum_over(wide, root_table) == sum_over(wide, root_bitwise);
+    agree &= sum_over(wide, root_table) == sum_over(wide, root_float);
+    r.run("isqrt", "bitwise", n, [&] { bench::do_not_optimize(sum_over(wide, root_bitwise)); });
+    r.run("isqrt", "std_sqrt", n, [&] { bench::do_not_optimize(sum_over(wide, root_float)); });
+    r.run("isqrt", "table", n, [&] { bench::do_not_optimize(sum_over(wide, root_table)); });
+
+    if (!agree)
+    {
+        std::fprintf(stderr, "a table disagrees with the computed values\n");
+        return 1;
+    }
+    return r.finish();
+}
@@ -0,0 +1,5 @@
+// The one translation unit that evaluates make_isqrt_table().
+
+#include "lookup_tables.h"
+
+constinit const std::array<std::uint8_t, 65536> isqrt_table = make_isqrt_table();
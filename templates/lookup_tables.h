@@ -0,0 +1,124 @@
+#pragma once
+
+// Whole lookup tables computed by the compiler, where meta_programming.cpp
+// computes one value per class template instantiation.
+//
+// Factorial<N>::value instantiates Factorial<N-1>, ..., Factorial<1>:
+// one class per value, each one kept by the compiler until the end of
+// the translation unit, recursion as deep as N (-ftemplate-depth), and
+// what comes out is a single number. A table of them needs an
+// index_sequence on top.
+//
+// A constexpr function is an ordinary loop that the compiler runs:
+//
+//   constexpr auto factorials = make_table<21>([](std::size_t n) { ... });
+//
+// make_table calls the generator for every index and returns a
+// std::array, so any table that can be written as "entry i is f(i)"
+// comes out whole. As a constexpr variable it is constant initialized:
+// it sits in the read-only data of the executable, costs nothing at
+// startup and cannot be written to. consteval instead of constexpr
+// makes the compiler refuse to ever run the generator at runtime.
+//
+// The tables below: factorials (all that fit 64 bits), binomial
+// coefficients (Pascal's triangle up to 64), the CRC-32 byte table, and
+// integer square roots of 0 .. 65535.
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+template <std::size_t N, typename Generator>
+consteval auto make_table(Generator generator)
+{
+    std::array<decltype(generator(std::size_t(0))), N> table{};
+    for (std::size_t i = 0; i < N; ++i)
+        table[i] = generator(i);
+    return table;
+}
+
+// 20! is the largest factorial that fits 64 bits.
+inline constexpr auto factorials = make_table<21>([](std::size_t n) {
+    std::uint64_t f = 1;
+    for (std::size_t i = 2; i <= n; ++i)
+        f *= i;
+    return f;
+});
+
+// binomials[n][k] = n choose k for n <= 64, built row by row as
+// Pascal's triangle (all of them fit 64 bits; C(67, 33) would not).
+inline constexpr std::size_t binomial_rows = 65;
+
+inline constexpr auto binomials = [] {
+    std::array<std::array<std::uint64_t, binomial_rows>, binomial_rows> table{};
+    for (std::size_t n = 0; n < binomial_rows; ++n)
+    {
+        table[n][0] = 1;
+        for (std::size_t k = 1; k <= n; ++k)
+            table[n][k] = table[n - 1][k - 1] + table[n - 1][k];
+    }
+    return table;
+}();
+
+// The reflected CRC-32 of zlib/PNG/Ethernet, one table entry per byte.
+inline constexpr std::uint32_t crc32_polynomial = 0xEDB88320u;
+
+constexpr std::uint32_t crc32_byte(std::uint32_t value)
+{
+    for (int bit = 0; bit < 8; ++bit)
+        value = (value & 1) ? (value >> 1) ^ crc32_polynomial : value >> 1;
+    return value;
+}
+
+inline constexpr auto crc32_table =
+    make_table<256>([](std::size_t byte) { return crc32_byte(static_cast<std::uint32_t>(byte)); });
+
+constexpr std::uint32_t crc32(const unsigned char* data, std::size_t size)
+{
+    std::uint32_t crc = 0xFFFFFFFFu;
+    for (std::size_t i = 0; i < size; ++i)
+        crc = crc32_table[(crc ^ data[i]) & 0xFFu] ^ (crc >> 8);
+    return crc ^ 0xFFFFFFFFu;
+}
+
+// floor(sqrt(x)) without floating point, usable in constant expressions.
+constexpr std::uint32_t isqrt(std::uint32_t x)
+{
+    std::uint32_t root = 0;
+    for (std::uint32_t bit = 1u << 30; bit != 0; bit >>= 2)
+        if (x >= root + bit)
+        {
+            x -= root + bit;
+            root = (root >> 1) + bit;
+        }
+        else
+            root >>= 1;
+    return root;
+}
+
+// Walked upwards instead of make_table(isqrt): the root only ever
+// grows by one. Even so GCC needs close to two seconds to evaluate 65536
+// entries, so the table is defined once, in lookup_tables.cpp, instead
+// of in every translation unit that includes this header. It is still
+// constant initialized (constinit there), just not usable in constant
+// expressions elsewhere; isqrt() is.
+constexpr std::array<std::uint8_t, 65536> make_isqrt_table()
+{
+    std::array<std::uint8_t, 65536> table{};
+    std::uint32_t root = 0;
+    for (std::uint32_t x = 0; x < table.size(); ++x)
+    {
+        if ((root + 1) * (root + 1) <= x)
+            ++root;
+        table[x] = static_cast<std::uint8_t>(root);
+    }
+    return table;
+}
+
+extern const std::array<std::uint8_t, 65536> isqrt_table;
+
+static_assert(factorials[10] == 3628800);
+static_assert(factorials[20] == 2432902008176640000ull);
+static_assert(binomials[10][3] == 120 && binomials[64][32] == 1832624140942590534ull);
+static_assert(crc32_table[1] == 0x77073096u);
+static_assert(isqrt(65535) == 255 && isqrt(48) == 6 && isqrt(49) == 7 && isqrt(1u << 30) == 1u << 15);
@@ -6,6 +6,8 @@
 
 #include <iostream>
 
+// One class per value; lookup_tables.h builds whole tables of them
+// with constexpr functions instead.
 template <int N>                                                                 // (2)
 struct Factorial{
     static int const value = N * Factorial<N-1>::value;
@@ -17,7 +19,7 @@ struct Factorial<1>{
 };
 
 // Manipulating Types at Compile Time
-// An example.
+// An example. (type_list.h maps traits like this one over lists of types.)
 template<typename T > 
 struct removeConst{ 
     typedef T type;               // (1)
@@ -0,0 +1,110 @@
+// Summing a column of --elements=N numbers (default 10^6, small whole
+// values, so every version adds up to exactly the same) whose element
+// type is known only at runtime, once per type of typed::element_types:
+//
+//   virtual_per_element  an interface with virtual double at(i), one
+//                        implementation per type: a call per element
+//   switch_per_element   a switch on the column's type for every element
+//   dispatch_once        typed::sum() of typed_kernels.h: one dispatch,
+//                        then the kernel made for the type
+//   known_type           sum_kernel<T> called directly, as if the type
+//                        were known where the code is written
+//
+// dispatch_once against known_type is what the runtime dispatch costs;
+// the per element versions show what it saves.
+
+#include "bench.h"
+#include "typed_kernels.h"
+
+#include <cstdio>
+#include <memory>
+#include <string>
+#include <vector>
+
+struct element_source
+{
+    virtual ~element_source() = default;
+    virtual std::size_t size() const = 0;
+    virtual double at(std::size_t i) const = 0;
+};
+
+template <typename T>
+struct typed_source final : element_source
+{
+    explicit typed_source(const std::vector<T>& values) : values(values) {}
+    std::size_t size() const override { return values.size(); }
+    double at(std::size_t i) const override { return static_cast<double>(values[i]); }
+
+    const std::vector<T>& values;
+};
+
+BENCH_NOINLINE double sum_virtual(const element_source& source)
+{
+    double total = 0;
+    for (std::size_t i = 0; i < source.size(); ++i)
+        total += source.at(i);
+    return total;
+}
+
+double value_at(const typed::column& c, std::size_t i)
+{
+    switch (c.type)
+    {
+    case tl::index_of_v<std::int8_t, typed::element_types>: return static_cast<const std::int8_t*>(c.data)[i];
+    case tl::index_of_v<std::int16_t, typed::element_types>: return static_cast<const std::int16_t*>(c.data)[i];
+    case tl::index_of_v<std::int32_t, typed::element_types>: return static_cast<const std::int32_t*>(c.data)[i];
+    case tl::index_of_v<std::int64_t, typed::element_types>:
+        return static_cast<double>(static_cast<const std::int64_t*>(c.data)[i]);
+    case tl::index_of_v<float, typed::element_types>: return static_cast<const float*>(c.data)[i];
+    default: return static_cast<const double*>(c.data)[i];
+    }
+}
+
+BENCH_NOINLINE double sum_switch(const typed::column& c)
+{
+    double total = 0;
+    for (std::size_t i = 0; i < c.size; ++i)
+        total += value_at(c, i);
+    return total;
+}
+
+BENCH_NOINLINE double sum_dispatched(const typed::column& c)
+{
+    return typed::sum(c);
+}
+
+constexpr const char* element_names[] = {"int8", "int16", "int32", "int64", "float", "double"};
+static_assert(std::size(element_names) == typed::element_types::size);
+
+int main(int argc, char** argv)
+{
+    bench::runner r("type_dispatch", argc, argv);
+
+    const auto n = static_cast<std::size_t>(r.param("elements", r.size(1000000L, 100000L)));
+    bool agree = true;
+
+    tl::for_each_type<typed::element_types>([&](auto tag) {
+        using T = typename decltype(tag)::type;
+        std::vector<T> values(n);
+        for (std::size_t i = 0; i < n; ++i)
+            values[i] = static_cast<T>(i % 100);
+        const typed::column c = typed::make_column(values);
+        const std::unique_ptr<element_source> source = std::make_unique<typed_source<T>>(values);
+        const std::string group = std::string("sum_") + element_names[c.type];
+
+        const double expected = static_cast<double>(typed::sum_kernel(values.data(), n));
+        agree &= sum_virtual(*source) == expected && sum_switch(c) == expected && sum_dispatched(c) == expected;
+
+        r.run(group, "virtual_per_element", n, [&] { bench::do_not_optimize(sum_virtual(*source)); });
+        r.run(group, "switch_per_element", n, [&] { bench::do_not_optimize(sum_switch(c)); });
+        r.run(group, "dispatch_once", n, [&] { bench::do_not_optimize(sum_dispatched(c)); });
+        r.run(group, "known_type", n, [&] { bench::do_not_optimize(typed::sum_kernel(values.data(), n)); });
+    });
+
+    if (!agree)
+    {
+        std::fprintf(stderr, "the sums disagree\n");
+        return 1;
+    }
+    return r.finish();
+}
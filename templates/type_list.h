@@ -0,0 +1,173 @@
+#pragma once
+
+// Lists of types and the handful of operations meta_programming.cpp's
+// removeConst is one instance of: a class template taking types and
+// giving a type (or a value) back.
+//
+//   using namespace tl;
+//   using numbers  = type_list<std::int8_t, std::int32_t, float, double>;
+//   using floats   = filter_t<std::is_floating_point, numbers>;   // type_list<float, double>
+//   using pointers = map_t<std::add_pointer, numbers>;            // type_list<std::int8_t*, ...>
+//   index_of_v<float, numbers>                                   // 2
+//
+// and the way back from runtime: a value that says which type of the
+// list some data holds (a column of a table, a message, a pixel format)
+// picks the instantiation of a generic lambda made for that type,
+//
+//   double total = dispatch<numbers>(type_index, [&](auto tag) {
+//       using T = typename decltype(tag)::type;
+//       return sum_kernel(static_cast<const T*>(data), size);
+//   });
+//
+// One indirect call per dispatch, through a table with one entry per
+// type; inside, the compiler knows T, so the loop over the data is
+// specialized (vectorized, for the types where it can be) instead of
+// asking every element for its type through a virtual call or a switch.
+
+#include <cassert>
+#include <cstddef>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+// at, map, filter and find would clash with std:: in a file that says
+// using namespace std, hence a namespace, as pipeline.h's lazy::.
+namespace tl {
+
+template <typename... Ts>
+struct type_list
+{
+    static constexpr std::size_t size = sizeof...(Ts);
+};
+
+// Carries a type into a generic lambda as a value.
+template <typename T>
+struct type_tag
+{
+    using type = T;
+};
+
+// The I-th type of List.
+template <std::size_t I, typename List>
+struct at;
+
+template <std::size_t I, typename... Ts>
+struct at<I, type_list<Ts...>>
+{
+    using type = std::tuple_element_t<I, std::tuple<Ts...>>;
+};
+
+template <std::size_t I, typename List>
+using at_t = typename at<I, List>::type;
+
+// All the lists, one after the other.
+template <typename... Lists>
+struct concat
+{
+    using type = type_list<>;
+};
+
+template <typename... Ts>
+struct concat<type_list<Ts...>>
+{
+    using type = type_list<Ts...>;
+};
+
+template <typename... As, typename... Bs, typename... Rest>
+struct concat<type_list<As...>, type_list<Bs...>, Rest...>
+{
+    using type = typename concat<type_list<As..., Bs...>, Rest...>::type;
+};
+
+template <typename... Lists>
+using concat_t = typename concat<Lists...>::type;
+
+// F<T>::type for every T of List (F as std::add_pointer, removeConst).
+template <template <typename> class F, typename List>
+struct map;
+
+template <template <typename> class F, typename... Ts>
+struct map<F, type_list<Ts...>>
+{
+    using type = type_list<typename F<Ts>::type...>;
+};
+
+template <template <typename> class F, typename List>
+using map_t = typename map<F, List>::type;
+
+// The T of List for which Pred<T>::value holds, in order.
+template <template <typename> class Pred, typename List>
+struct filter;
+
+template <template <typename> class Pred, typename... Ts>
+struct filter<Pred, type_list<Ts...>>
+{
+    using type = concat_t<std::conditional_t<Pred<Ts>::value, type_list<Ts>, type_list<>>...>;
+};
+
+template <template <typename> class Pred, typename List>
+using filter_t = typename filter<Pred, List>::type;
+
+// The position of T in List (its first occurrence), List::size if absent.
+template <typename T, typename List>
+struct find;
+
+template <typename T, typename... Ts>
+struct find<T, type_list<Ts...>>
+{
+    static constexpr std::size_t value = [] {
+        constexpr bool same[] = {std::is_same_v<T, Ts>..., false};
+        std::size_t i = 0;
+        while (i < sizeof...(Ts) && !same[i])
+            ++i;
+        return i;
+    }();
+};
+
+template <typename T, typename List>
+inline constexpr bool contains_v = find<T, List>::value < List::size;
+
+// As find, but not being in the list is a compile error.
+template <typename T, typename List>
+inline constexpr std::size_t index_of_v = [] {
+    static_assert(contains_v<T, List>, "the type is not in the list");
+    return find<T, List>::value;
+}();
+
+// f(type_tag<T>{}) for every T of List, in order.
+template <typename List, typename F>
+void for_each_type(F&& f)
+{
+    [&]<typename... Ts>(type_list<Ts...>) { (f(type_tag<Ts>{}), ...); }(List{});
+}
+
+namespace detail {
+
+template <typename F, typename... Ts>
+decltype(auto) dispatch(type_list<Ts...>, std::size_t index, F& f)
+{
+    using result = std::common_type_t<std::invoke_result_t<F&, type_tag<Ts>>...>;
+    using entry = result (*)(F&);
+    static constexpr entry table[] = {[](F& g) -> result { return g(type_tag<Ts>{}); }...};
+    return table[index](f);
+}
+
+} // namespace detail
+
+// f(type_tag<T>{}) for T = at_t<index, List>, picked at runtime; the
+// results of all the instantiations must have a common type.
+template <typename List, typename F>
+decltype(auto) dispatch(std::size_t index, F&& f)
+{
+    static_assert(List::size > 0, "nothing to dispatch to");
+    assert(index < List::size);
+    return detail::dispatch(List{}, index, f);
+}
+
+static_assert(std::is_same_v<at_t<1, type_list<int, char>>, char>);
+static_assert(std::is_same_v<concat_t<type_list<int>, type_list<>, type_list<char, int>>, type_list<int, char, int>>);
+static_assert(std::is_same_v<map_t<std::remove_const, type_list<const int, char>>, type_list<int, char>>);
+static_assert(std::is_same_v<filter_t<std::is_integral, type_list<int, float, char>>, type_list<int, char>>);
+static_assert(index_of_v<char, type_list<int, char, char>> == 1 && !contains_v<float, type_list<int>>);
+
+} // namespace tl
@@ -0,0 +1,99 @@
+#pragma once
+
+// A column of numbers whose element type is only known at runtime (read
+// from a file, chosen by the user), and a sum over it that runs a loop
+// made for that type:
+//
+//   std::vector<std::int16_t> values = ...;
+//   double total = typed::sum(typed::make_column(values));
+//
+// sum() dispatches once (type_list.h) to sum_kernel<T>, so the loop has
+// no per element question of what the element is. Which loop is picked
+// per type at compile time, from the lists below:
+//
+// - integers add up exactly in any order, so the plain loop is what the
+//   compiler vectorizes (widening into a 64 bit accumulator);
+// - floating point addition is not associative: without -ffast-math the
+//   compiler must add one element after the other, every add waiting on
+//   the previous one. lane_split_types get a kernel with eight partial
+//   sums instead, which can run in parallel (and differ from the plain
+//   loop in the last bits, as any reordered floating point sum does).
+
+#include "type_list.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+#include <vector>
+
+namespace typed {
+
+using element_types = tl::type_list<std::int8_t, std::int16_t, std::int32_t, std::int64_t, float, double>;
+
+// What a sum over T accumulates in.
+template <typename T>
+struct accumulator
+{
+    using type = std::conditional_t<std::is_floating_point_v<T>, double, std::int64_t>;
+};
+
+using accumulator_types = tl::map_t<accumulator, element_types>;
+
+// Types whose sum the compiler may not reorder by itself.
+using lane_split_types = tl::filter_t<std::is_floating_point, element_types>;
+
+template <typename T>
+typename accumulator<T>::type sum_kernel(const T* data, std::size_t size)
+{
+    using acc = typename accumulator<T>::type;
+    if constexpr (tl::contains_v<T, lane_split_types>)
+    {
+        constexpr std::size_t lanes = 8;
+        acc partial[lanes] = {};
+        std::size_t i = 0;
+        for (; i + lanes <= size; i += lanes)
+            for (std::size_t l = 0; l < lanes; ++l)
+                partial[l] += data[i + l];
+        acc total = 0;
+        for (; i < size; ++i)
+            total += data[i];
+        for (acc p : partial)
+            total += p;
+        return total;
+    }
+    else
+    {
+        acc total = 0;
+        for (std::size_t i = 0; i < size; ++i)
+            total += data[i];
+        return total;
+    }
+}
+
+// A type-erased view of a contiguous array of one of element_types.
+struct column
+{
+    std::size_t type;   // index into element_types
+    const void* data;
+    std::size_t size;
+};
+
+template <typename T>
+column make_column(const std::vector<T>& values)
+{
+    return {tl::index_of_v<T, element_types>, values.data(), values.size()};
+}
+
+// The sum as a double, whatever the column holds.
+inline double sum(const column& c)
+{
+    return tl::dispatch<element_types>(c.type, [&](auto tag) {
+        using T = typename decltype(tag)::type;
+        return static_cast<double>(sum_kernel(static_cast<const T*>(c.data), c.size));
+    });
+}
+
+static_assert(std::is_same_v<tl::at_t<4, accumulator_types>, double>);
+static_assert(std::is_same_v<lane_split_types, tl::type_list<float, double>>);
+
+} // namespace typed